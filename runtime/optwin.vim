@@ -1049,6 +1049,10 @@ call append("$", "maxmem\tmaximum amount of memory in Kbyte used for one buffer"
 call append("$", " \tset mm=" . &mm)
 call append("$", "maxmemtot\tmaximum amount of memory in Kbyte used for all buffers")
 call append("$", " \tset mmt=" . &mmt)
+if has("lazyread")
+  call append("$", "lazyread\tminimal size in Kbyte of a file that is read lazily")
+  call append("$", " \tset lzr=" . &lzr)
+endif
 
 
 call <SID>Header("command line editing")
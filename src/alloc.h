@@ -17,5 +17,6 @@ typedef enum {
 	aid_qf_namebuf,
 	aid_qf_errmsg,
 	aid_qf_pattern,
+	aid_lazy_ptrs,
 	aid_last
 } alloc_id_T;
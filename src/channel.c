@@ -3330,6 +3330,11 @@ channel_read(channel_T *channel, ch_part_T part, char *func)
 	/* signal the main loop that there is something to read */
 	gtk_main_quit();
 #endif
+#if defined(CH_HAS_GUI) && defined(FEAT_GUI_QT)
+    else if (CH_HAS_GUI)
+	/* signal the main loop that there is something to read */
+	qt_interrupt_wait();
+#endif
 }
 
 /*
@@ -3638,6 +3643,37 @@ channel_any_keep_open()
 }
 # endif
 
+# if defined(FEAT_GUI_QT) || defined(PROTO)
+/*
+ * Call "func" for the file descriptors of channels with a keep_open flag.
+ * These are not registered with the GUI, the GUI watches them while
+ * waiting for a character.
+ */
+    void
+channel_keep_open_fds(void (*func)(int fd))
+{
+    channel_T	*channel;
+    ch_part_T	part;
+
+    for (channel = first_channel; channel != NULL; channel = channel->ch_next)
+    {
+	if (!channel->ch_keep_open)
+	    continue;
+	for (part = PART_SOCK; part < PART_IN; ++part)
+	{
+	    sock_T fd = channel->ch_part[part].ch_fd;
+
+	    if (fd != INVALID_FD
+		    && (part == PART_SOCK
+			|| fd != channel->ch_part[PART_SOCK].ch_fd)
+		    && (part != PART_ERR
+			|| fd != channel->ch_part[PART_OUT].ch_fd))
+		func((int)fd);
+	}
+    }
+}
+# endif
+
 /*
  * Set "channel"/"part" to non-blocking.
  * Only works for sockets and pipes.
@@ -87,6 +87,8 @@ buf_init_chartab(
 
     if (global)
     {
+	++chartab_tick;
+
 	/*
 	 * Set the default size for printable characters:
 	 * From <Space> to '~' is 1 (printable), others are 2 (not printable).
@@ -196,6 +196,7 @@ static void f_getwinvar(typval_T *argvars, typval_T *rettv);
 static void f_glob(typval_T *argvars, typval_T *rettv);
 static void f_globpath(typval_T *argvars, typval_T *rettv);
 static void f_glob2regpat(typval_T *argvars, typval_T *rettv);
+static void f_guiprofile(typval_T *argvars, typval_T *rettv);
 static void f_has(typval_T *argvars, typval_T *rettv);
 static void f_has_key(typval_T *argvars, typval_T *rettv);
 static void f_haslocaldir(typval_T *argvars, typval_T *rettv);
@@ -632,6 +633,7 @@ static struct fst
     {"glob",		1, 4, f_glob},
     {"glob2regpat",	1, 1, f_glob2regpat},
     {"globpath",	2, 5, f_globpath},
+    {"guiprofile",	0, 1, f_guiprofile},
     {"has",		1, 1, f_has},
     {"has_key",		2, 2, f_has_key},
     {"haslocaldir",	0, 2, f_haslocaldir},
@@ -5520,6 +5522,28 @@ f_glob2regpat(typval_T *argvars, typval_T *rettv)
 			 ? NULL : file_pat_to_reg_pat(pat, NULL, NULL, FALSE);
 }
 
+/*
+ * "guiprofile([{fname}])" function
+ */
+    static void
+f_guiprofile(typval_T *argvars, typval_T *rettv)
+{
+    char_u	*fname = NULL;
+
+    if (rettv_dict_alloc(rettv) != OK)
+	return;
+    if (argvars[0].v_type != VAR_UNKNOWN)
+    {
+	fname = get_tv_string_chk(&argvars[0]);
+	if (fname == NULL)
+	    return;
+    }
+#ifdef FEAT_GUI_QT
+    if (gui.in_use)
+	gui_mch_profile(rettv->vval.v_dict, fname);
+#endif
+}
+
 /* for VIM_VERSION_ defines */
 #include "version.h"
 
@@ -5757,6 +5781,9 @@ f_has(typval_T *argvars, typval_T *rettv)
 #ifdef FEAT_LANGMAP
 	"langmap",
 #endif
+#ifdef FEAT_LAZYREAD
+	"lazyread",
+#endif
 #ifdef FEAT_LIBCALL
 	"libcall",
 #endif
@@ -5904,6 +5931,9 @@ f_has(typval_T *argvars, typval_T *rettv)
 #ifdef FEAT_SUN_WORKSHOP
 	"sun_workshop",
 #endif
+#ifdef FEAT_SWAP_THREAD
+	"swapthread",
+#endif
 #ifdef FEAT_NETBEANS_INTG
 	"netbeans_intg",
 #endif
@@ -12569,6 +12599,8 @@ f_test_override(typval_T *argvars, typval_T *rettv UNUSED)
 	    disable_redraw_for_testing = val;
 	else if (STRCMP(name, (char_u *)"char_avail") == 0)
 	    disable_char_avail_for_testing = val;
+	else if (STRCMP(name, (char_u *)"copy_chunk") == 0)
+	    copy_chunk_for_testing = val;
 	else if (STRCMP(name, (char_u *)"starting") == 0)
 	{
 	    if (val)
@@ -12587,6 +12619,7 @@ f_test_override(typval_T *argvars, typval_T *rettv UNUSED)
 	{
 	    disable_char_avail_for_testing = FALSE;
 	    disable_redraw_for_testing = FALSE;
+	    copy_chunk_for_testing = 0;
 	    if (save_starting >= 0)
 	    {
 		starting = save_starting;
@@ -1368,6 +1368,24 @@
 # define FEAT_PERSISTENT_UNDO
 #endif
 
+/*
+ * +lazyread		'lazyread' option: large files are used from a mapping
+ *			of the file, text is only copied when it is needed.
+ */
+#if defined(FEAT_BIG) && defined(UNIX) && defined(HAVE_MMAP) \
+	&& defined(HAVE_SYS_MMAN_H)
+# define FEAT_LAZYREAD
+#endif
+
+/*
+ * +swapthread		The swap file is written by a separate thread when it
+ *			is synced after 'updatetime' or 'updatecount'.
+ */
+#if defined(FEAT_NORMAL) && defined(UNIX) && defined(HAVE_PTHREAD_H) \
+	&& defined(HAVE_PWRITE)
+# define FEAT_SWAP_THREAD
+#endif
+
 /*
  * +filterpipe
  */
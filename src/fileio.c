@@ -21,7 +21,12 @@
 # include <utime.h>		/* for struct utimbuf */
 #endif
 
+#ifdef __SSE2__
+# include <emmintrin.h>		/* for scanning 16 bytes at a time */
+#endif
+
 #define BUFSIZE		8192	/* size of normal write buffer */
+#define WRITEBUFSIZE	65536	/* size of buffer for writing the text */
 #define SMBUFSIZE	256	/* size of emergency write buffer */
 
 /* Is there any system that doesn't have access()? */
@@ -42,6 +47,14 @@ static char_u *check_for_cryptkey(char_u *cryptkey, char_u *ptr, long *sizep, of
 #ifdef UNIX
 static void set_file_time(char_u *fname, time_t atime, time_t mtime);
 #endif
+static char_u *readfile_find_eol(char_u *p, char_u *end, int cr);
+#ifdef FEAT_MBYTE
+static char_u *readfile_skip_ascii(char_u *p, char_u *end);
+#endif
+#ifdef FEAT_LAZYREAD
+static linenr_T readfile_lazy(int fd, off_T start, int dos, off_T *endp);
+static int readfile_lazy_check(char_u *start, char_u *end, int dos);
+#endif
 static int set_rw_fname(char_u *fname, char_u *sfname);
 static int msg_add_fileformat(int eol_type);
 static void msg_add_eol(void);
@@ -254,6 +267,9 @@ readfile(
     int		read_undo_file = FALSE;
 #endif
     int		split = 0;		/* number of split lines */
+#ifdef FEAT_LAZYREAD
+    int		try_lazy = FALSE;	/* may read the file lazily */
+#endif
 #define UNKNOWN	 0x0fffffff		/* file size is unknown */
     linenr_T	linecnt;
     int		error = FALSE;		/* errors encountered */
@@ -1196,6 +1212,23 @@ retry:
 #endif
     }
 
+#ifdef FEAT_LAZYREAD
+    /* Only a new file is read lazily, when the text is used as it is. */
+    try_lazy = (p_lzr > 0 && newfile && wasempty && from == 0
+	    && lines_to_skip == 0 && lines_to_read == MAXLNUM
+	    && !filtering && !read_stdin && !read_buffer && !read_fifo
+# ifdef FEAT_PERSISTENT_UNDO
+	    && !read_undo_file
+# endif
+# ifdef FEAT_MBYTE
+	    && fio_flags == 0 && tmpname == NULL
+#  ifdef USE_ICONV
+	    && iconv_fd == (iconv_t)-1
+#  endif
+# endif
+	    );
+#endif
+
     while (!error && !got_int)
     {
 	/*
@@ -2039,9 +2072,11 @@ retry:
 		/* Reading UTF-8: Check if the bytes are valid UTF-8. */
 		for (p = ptr; ; ++p)
 		{
-		    int	 todo = (int)((ptr + size) - p);
+		    int	 todo;
 		    int	 l;
 
+		    p = readfile_skip_ascii(p, ptr + size);
+		    todo = (int)((ptr + size) - p);
 		    if (todo <= 0)
 			break;
 		    if (*p >= 0x80)
@@ -2134,7 +2169,8 @@ rewind_retry:
 		    if (try_mac)
 			try_mac = 1;
 
-		    for (p = ptr; p < ptr + size; ++p)
+		    for (p = ptr; (p = readfile_find_eol(p, ptr + size, try_mac))
+							     < ptr + size; ++p)
 		    {
 			if (*p == NL)
 			{
@@ -2145,7 +2181,7 @@ rewind_retry:
 				fileformat = EOL_UNIX;
 			    break;
 			}
-			else if (*p == CAR && try_mac)
+			else if (*p == CAR)
 			    try_mac++;
 		    }
 
@@ -2159,7 +2195,8 @@ rewind_retry:
 			    ;
 			if (p >= ptr)
 			{
-			    for (p = ptr; p < ptr + size; ++p)
+			    for (p = ptr; (p = readfile_find_eol(p, ptr + size,
+						    TRUE)) < ptr + size; ++p)
 			    {
 				if (*p == NL)
 				    try_unix++;
@@ -2190,6 +2227,39 @@ rewind_retry:
 	    }
 	}
 
+#ifdef FEAT_LAZYREAD
+	/*
+	 * When reading the first part of a large file: the lines may be used
+	 * from a mapping of the file, see 'lazyread'.  What comes after the
+	 * last line break is read below.
+	 */
+	if (try_lazy && size > 0 && lnum == from && linerest == 0
+		&& (fileformat == EOL_UNIX || fileformat == EOL_DOS)
+# ifdef FEAT_CRYPT
+		&& cryptkey == NULL
+# endif
+		)
+	{
+	    off_T	lazy_end;
+	    linenr_T	lazy_lines;
+
+	    try_lazy = FALSE;
+	    lazy_lines = readfile_lazy(fd, filesize - size,
+					     fileformat == EOL_DOS, &lazy_end);
+	    if (lazy_lines > 0
+		    && vim_lseek(fd, lazy_end, SEEK_SET) == lazy_end)
+	    {
+		lnum += lazy_lines;
+		filesize = lazy_end;
+		line_start = ptr;
+		size = 0;
+# ifdef FEAT_MBYTE
+		conv_restlen = 0;
+# endif
+	    }
+	}
+#endif
+
 	/*
 	 * This loop is executed once for every character read.
 	 * Keep it fast!
@@ -2199,9 +2269,15 @@ rewind_retry:
 	    --ptr;
 	    while (++ptr, --size >= 0)
 	    {
-		/* catch most common case first */
+		/* catch most common case first: skip to the next NUL, CR or NL
+		 * in one go */
 		if ((c = *ptr) != NUL && c != CAR && c != NL)
+		{
+		    p = readfile_find_eol(ptr + 1, ptr + 1 + size, TRUE);
+		    size -= (long)(p - ptr - 1);
+		    ptr = p - 1;
 		    continue;
+		}
 		if (c == NUL)
 		    *ptr = NL;	/* NULs are replaced by newlines! */
 		else if (c == NL)
@@ -2241,7 +2317,13 @@ rewind_retry:
 	    while (++ptr, --size >= 0)
 	    {
 		if ((c = *ptr) != NUL && c != NL)  /* catch most common case */
+		{
+		    /* Skip to the next NUL or NL in one go. */
+		    p = readfile_find_eol(ptr + 1, ptr + 1 + size, FALSE);
+		    size -= (long)(p - ptr - 1);
+		    ptr = p - 1;
 		    continue;
+		}
 		if (c == NUL)
 		    *ptr = NL;	/* NULs are replaced by newlines! */
 		else
@@ -2748,6 +2830,164 @@ is_dev_fd_file(char_u *fname)
 }
 #endif
 
+/*
+ * Return a pointer to the first NUL or NL from "p" up to "end", also stop at
+ * a CR when "cr" is TRUE.  Returns "end" when there is none.
+ * Used for every byte of a file that is read, thus looks at 16 bytes (or a
+ * long_u) at a time.
+ */
+    static char_u *
+readfile_find_eol(char_u *p, char_u *end, int cr)
+{
+#ifdef __SSE2__
+    __m128i	nul = _mm_setzero_si128();
+    __m128i	nl = _mm_set1_epi8(NL);
+    __m128i	car = _mm_set1_epi8(cr ? CAR : NL);
+    __m128i	v;
+    int		mask;
+
+    while (end - p >= 16)
+    {
+	v = _mm_loadu_si128((__m128i *)p);
+	mask = _mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(v, nul),
+		   _mm_or_si128(_mm_cmpeq_epi8(v, nl), _mm_cmpeq_epi8(v, car))));
+	if (mask != 0)
+	{
+	    while ((mask & 1) == 0)
+	    {
+		mask >>= 1;
+		++p;
+	    }
+	    return p;
+	}
+	p += 16;
+    }
+#else
+    long_u	ones = (long_u)-1 / 0xff;	/* 0x0101...01 */
+    long_u	w, n, c;
+
+    /* A word has a zero byte when "(w - ones) & ~w" has a high bit set. */
+    while (end - p >= (long)sizeof(long_u))
+    {
+	mch_memmove(&w, p, sizeof(long_u));
+	n = w ^ (ones * NL);
+	c = w ^ (ones * (cr ? CAR : NL));
+	if ((((w - ones) & ~w) | ((n - ones) & ~n) | ((c - ones) & ~c))
+							       & (ones * 0x80))
+	    break;
+	p += sizeof(long_u);
+    }
+#endif
+    while (p < end && *p != NUL && *p != NL && !(cr && *p == CAR))
+	++p;
+    return p;
+}
+
+#ifdef FEAT_MBYTE
+/*
+ * Return a pointer to the first byte from "p" up to "end" that is not ASCII.
+ * Returns "end" when there is none.
+ */
+    static char_u *
+readfile_skip_ascii(char_u *p, char_u *end)
+{
+# ifdef __SSE2__
+    while (end - p >= 16
+	    && _mm_movemask_epi8(_mm_loadu_si128((__m128i *)p)) == 0)
+	p += 16;
+# else
+    long_u	high = ((long_u)-1 / 0xff) * 0x80;  /* 0x8080...80 */
+    long_u	w;
+
+    while (end - p >= (long)sizeof(long_u))
+    {
+	mch_memmove(&w, p, sizeof(long_u));
+	if (w & high)
+	    break;
+	p += sizeof(long_u);
+    }
+# endif
+    while (p < end && *p < 0x80)
+	++p;
+    return p;
+}
+#endif
+
+#ifdef FEAT_LAZYREAD
+/*
+ * Read file "fd" lazily from offset "start", see 'lazyread'.  The lines up to
+ * the last line break are appended to the empty current buffer without
+ * copying them.  Returns the number of lines and sets "*endp" to the offset
+ * just after them.  Returns zero when the file is too small or the text can't
+ * be used as it is.
+ */
+    static linenr_T
+readfile_lazy(int fd, off_T start, int dos, off_T *endp)
+{
+    stat_T	st;
+    char_u	*base;
+    off_T	end;
+    linenr_T	lines = 0;
+
+    if (mch_fstat(fd, &st) < 0 || !S_ISREG(st.st_mode)
+	    || st.st_size / 1024 < p_lzr
+	    || (off_T)(size_t)st.st_size != st.st_size)
+	return 0;
+    base = (char_u *)mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE,
+								 fd, (off_t)0);
+    if (base == (char_u *)MAP_FAILED)
+	return 0;
+
+    for (end = st.st_size; end > start && base[end - 1] != NL; --end)
+	;
+    if (end > start
+	    && readfile_lazy_check(base + start, base + st.st_size, dos) == OK)
+	lines = ml_append_mapped(base, st.st_size, &st, start, end, dos);
+    if (lines == 0)
+	(void)munmap(base, (size_t)st.st_size);
+    else
+    {
+	*endp = end;
+# ifdef MADV_DONTNEED
+	/* The text was only scanned, it doesn't need to stay resident. */
+	(void)madvise((void *)base, (size_t)st.st_size, MADV_DONTNEED);
+# endif
+    }
+    return lines;
+}
+
+/*
+ * Check that the text from "start" to "end" can be used without changes.
+ * When reading UTF-8 it must be valid, an incomplete character at the end is
+ * not accepted either.  With "dos" every NL must come after a CR.
+ */
+    static int
+readfile_lazy_check(char_u *start, char_u *end, int dos)
+{
+    char_u	*p;
+# ifdef FEAT_MBYTE
+    int		l;
+# endif
+
+    if (dos)
+	for (p = start; (p = (char_u *)memchr(p, NL, (size_t)(end - p)))
+							      != NULL; ++p)
+	    if (p == start || p[-1] != CAR)
+		return FAIL;
+
+# ifdef FEAT_MBYTE
+    if (enc_utf8 && !curbuf->b_p_bin)
+	for (p = start; (p = readfile_skip_ascii(p, end)) < end; p += l)
+	{
+	    l = utf_ptr2len_len(p, (int)(end - p > 6 ? 6 : end - p));
+	    if (l == 1 || l > end - p)
+		return FAIL;
+	}
+# endif
+    return OK;
+}
+#endif
+
 #ifdef FEAT_MBYTE
 
 /*
@@ -3149,6 +3389,8 @@ buf_write(
     char_u	    *ptr;
     char_u	    c;
     int		    len;
+    int		    span;
+    int		    n;
     linenr_T	    lnum;
     long	    nchars;
     char_u	    *errmsg = NULL;
@@ -3537,7 +3779,7 @@ buf_write(
 		    (char_u *)"", 0);	/* show that we are busy */
     msg_scroll = FALSE;		    /* always overwrite the file message now */
 
-    buffer = alloc(BUFSIZE);
+    buffer = alloc(WRITEBUFSIZE);
     if (buffer == NULL)		    /* can't allocate big buffer, use small
 				     * one (to be able to write when out of
 				     * memory) */
@@ -3546,7 +3788,7 @@ buf_write(
 	bufsize = SMBUFSIZE;
     }
     else
-	bufsize = BUFSIZE;
+	bufsize = WRITEBUFSIZE;
 
     /*
      * Get information about original file (if there is one).
@@ -4013,6 +4255,11 @@ buf_write(
 			write_info.bw_buf = copybuf;
 #ifdef HAS_BW_FLAGS
 			write_info.bw_flags = FIO_NOCONVERT;
+#endif
+#ifdef UNIX
+			/* Let the file system share or copy the blocks, what
+			 * remains is copied below. */
+			(void)mch_copy_file_data(fd, bfd, (off_T)st_old.st_size);
 #endif
 			while ((write_info.bw_len = read_eintr(fd, copybuf,
 								BUFSIZE)) > 0)
@@ -4381,6 +4628,11 @@ buf_write(
 	     * Appending will fail if the file does not exist and forceit is
 	     * FALSE.
 	     */
+#ifdef FEAT_LAZYREAD
+	    /* A buffer may still use the text of the file we overwrite. */
+	    if (!append)
+		ml_unmap_file(wfname);
+#endif
 	    while ((fd = mch_open((char *)wfname, O_WRONLY | O_EXTRA | (append
 				? (forceit ? (O_APPEND | O_CREAT) : O_APPEND)
 				: (O_CREAT | O_TRUNC))
@@ -4579,24 +4831,46 @@ restore_backup:
 	len = 0;
 	for (lnum = start; lnum <= end; ++lnum)
 	{
-	    /*
-	     * The next while loop is done once for each character written.
-	     * Keep it fast!
-	     */
-	    ptr = ml_get_buf(buf, lnum, FALSE) - 1;
+	    ptr = ml_get_buf(buf, lnum, FALSE);
 #ifdef FEAT_PERSISTENT_UNDO
 	    if (write_undo_file)
-		sha256_update(&sha_ctx, ptr + 1,
-					      (UINT32_T)(STRLEN(ptr + 1) + 1));
+		sha256_update(&sha_ctx, ptr, (UINT32_T)(STRLEN(ptr) + 1));
 #endif
-	    while ((c = *++ptr) != NUL)
+	    for (;;)
 	    {
+		/*
+		 * Copy the text up to a character that needs to be replaced
+		 * at once, it is done for every line written.  Keep it fast!
+		 */
+		span = (int)strcspn((char *)ptr,
+					fileformat == EOL_MAC ? "\n\r" : "\n");
+		while (span > 0)
+		{
+		    n = MIN(span, bufsize - len);
+		    mch_memmove(s, ptr, (size_t)n);
+		    s += n;
+		    ptr += n;
+		    span -= n;
+		    if ((len += n) != bufsize)
+			continue;
+		    if (buf_write_bytes(&write_info) == FAIL)
+		    {
+			end = 0;	/* write error: break loop */
+			break;
+		    }
+		    nchars += bufsize;
+		    s = buffer;
+		    len = 0;
+#ifdef FEAT_MBYTE
+		    write_info.bw_start_lnum = lnum;
+#endif
+		}
+		if (end == 0 || (c = *ptr++) == NUL)
+		    break;
 		if (c == NL)
 		    *s = NUL;		/* replace newlines with NULs */
-		else if (c == CAR && fileformat == EOL_MAC)
-		    *s = NL;		/* Mac: replace CRs with NLs */
 		else
-		    *s = c;
+		    *s = NL;		/* Mac: replace CRs with NLs */
 		++s;
 		if (++len != bufsize)
 		    continue;
@@ -4539,6 +4539,82 @@ scroll_line_len(linenr_T lnum)
  * search for it when scrolling horizontally. */
 static linenr_T longest_lnum = 0;
 
+/* The lengths of the visible lines, measured by gui_find_longest_lnum().
+ * They are reused until the text, the view or the options that affect the
+ * line length change, moving the cursor does not measure them again. */
+static struct
+{
+    int		win_id;
+    int		buf_fnum;
+    varnumber_T	changedtick;
+    linenr_T	topline;
+    linenr_T	botline;
+    long	ts;
+    int		list;
+    int		lcs_tab1;
+    int		ambw;
+    int		chartab_tick;
+    colnr_T	*len;		/* length of topline..botline-1 */
+    int		len_size;
+} visible_len;
+
+/*
+ * Return TRUE when visible_len holds the line lengths for curwin.
+ */
+    static int
+visible_len_valid(void)
+{
+    return visible_len.len != NULL
+	    && visible_len.win_id == curwin->w_id
+	    && visible_len.buf_fnum == curbuf->b_fnum
+	    && visible_len.changedtick == CHANGEDTICK(curbuf)
+	    && visible_len.topline == curwin->w_topline
+	    && visible_len.botline == curwin->w_botline
+	    && visible_len.ts == curbuf->b_p_ts
+	    && visible_len.list == curwin->w_p_list
+	    && visible_len.lcs_tab1 == lcs_tab1
+	    && visible_len.ambw == *p_ambw
+	    && visible_len.chartab_tick == chartab_tick;
+}
+
+/*
+ * Get the lengths of the visible lines in curwin, from visible_len when
+ * possible.  Returns NULL when out of memory.
+ */
+    static colnr_T *
+gui_visible_line_len(void)
+{
+    int		count = (int)(curwin->w_botline - curwin->w_topline);
+    linenr_T	lnum;
+
+    if (visible_len_valid())
+	return visible_len.len;
+
+    if (count > visible_len.len_size)
+    {
+	vim_free(visible_len.len);
+	visible_len.len = (colnr_T *)alloc(count * sizeof(colnr_T));
+	visible_len.len_size = visible_len.len == NULL ? 0 : count;
+	if (visible_len.len == NULL)
+	    return NULL;
+    }
+
+    for (lnum = curwin->w_topline; lnum < curwin->w_botline; ++lnum)
+	visible_len.len[lnum - curwin->w_topline] = scroll_line_len(lnum);
+
+    visible_len.win_id = curwin->w_id;
+    visible_len.buf_fnum = curbuf->b_fnum;
+    visible_len.changedtick = CHANGEDTICK(curbuf);
+    visible_len.topline = curwin->w_topline;
+    visible_len.botline = curwin->w_botline;
+    visible_len.ts = curbuf->b_p_ts;
+    visible_len.list = curwin->w_p_list;
+    visible_len.lcs_tab1 = lcs_tab1;
+    visible_len.ambw = *p_ambw;
+    visible_len.chartab_tick = chartab_tick;
+    return visible_len.len;
+}
+
 /*
  * Find longest visible line number.  If this is not possible (or not desired,
  * by setting 'h' in "guioptions") then the current line number is returned.
@@ -4547,6 +4623,7 @@ static linenr_T longest_lnum = 0;
 gui_find_longest_lnum(void)
 {
     linenr_T ret = 0;
+    colnr_T  *len;
 
     /* Calculate maximum for horizontal scrollbar.  Check for reasonable
      * line numbers, topline and botline can be invalid when displaying is
@@ -4554,7 +4631,8 @@ gui_find_longest_lnum(void)
     if (vim_strchr(p_go, GO_HORSCROLL) == NULL
 	    && curwin->w_topline <= curwin->w_cursor.lnum
 	    && curwin->w_botline > curwin->w_cursor.lnum
-	    && curwin->w_botline <= curbuf->b_ml.ml_line_count + 1)
+	    && curwin->w_botline <= curbuf->b_ml.ml_line_count + 1
+	    && (len = gui_visible_line_len()) != NULL)
     {
 	linenr_T    lnum;
 	colnr_T	    n;
@@ -4565,7 +4643,7 @@ gui_find_longest_lnum(void)
 	 * below. */
 	for (lnum = curwin->w_topline; lnum < curwin->w_botline; ++lnum)
 	{
-	    n = scroll_line_len(lnum);
+	    n = len[lnum - curwin->w_topline];
 	    if (n > (colnr_T)max)
 	    {
 		max = n;
@@ -4623,7 +4701,12 @@ gui_update_horiz_scrollbar(int force)
 	value = curwin->w_leftcol;
 
 	longest_lnum = gui_find_longest_lnum();
-	max = scroll_line_len(longest_lnum);
+	if (visible_len_valid()
+		&& longest_lnum >= curwin->w_topline
+		&& longest_lnum < curwin->w_botline)
+	    max = visible_len.len[longest_lnum - curwin->w_topline];
+	else
+	    max = scroll_line_len(longest_lnum);
 
 #ifdef FEAT_VIRTUALEDIT
 	if (virtual_active())
@@ -14,12 +14,18 @@
 #include <QMimeData>
 #include <QSocketNotifier>
 #include <QTimer>
+#include <QElapsedTimer>
 
 #include "qvimshell.h"
 #include "mainwindow.h"
 #include "vimaction.h"
 #include "vimscrollbar.h"
 #include "fontdialog.h"
+#include "colortable.h"
+#include "drawtrace.h"
+#include "signicon.h"
+#include "vimmimedata.h"
+#include "fontprobe.h"
 
 extern "C" {
 
@@ -28,10 +34,12 @@ extern "C" {
 
 static QVimShell *vimshell = NULL;
 static MainWindow *window = NULL;
+static DrawTrace *drawTrace = NULL;
+static FontProbe fontProbe;
 
-static QColor foregroundColor;
-static QColor backgroundColor;
-static QColor specialColor;
+static QRgb foregroundColor;
+static QRgb backgroundColor;
+static QRgb specialColor;
 
 
 /*
@@ -50,6 +58,8 @@ static char *dummy_argv[] = {"qvim", NULL};
  */
 static bool start_fullscreen = false;
 
+static bool qt_profile_dump(const QString& fname);
+
 void gui_mch_enter_fullscreen()
 {
 	if (!window) {
@@ -132,18 +142,19 @@ gui_mch_get_font(char_u *name, int giveErrorIfMissing)
 	// + If giveErrorIfMissing is true, throw an error message, otherwise fail silently
 	// * We open an exception for the Monospace font, we ALWAYS load the monospace font
 	//
-	QFontInfo fi(font);
-
-	if ( fi.family().compare(font.family(), Qt::CaseInsensitive) != 0 &&
-		font.family().compare("Monospace", Qt::CaseInsensitive) != 0) {
+	// The verdict is kept in the font cache, see FontProbeCache
+	//
+	FontProbe probe;
+	if ( !FontProbeCache::lookup(family, &probe) ) {
+		QFontInfo fi(font);
 
-		if ( giveErrorIfMissing ) {
-			EMSG2(e_font, name);
-		}
-		return NOFONT;
+		probe.valid = fi.fixedPitch() &&
+			(fi.family().compare(font.family(), Qt::CaseInsensitive) == 0 ||
+			 font.family().compare("Monospace", Qt::CaseInsensitive) == 0);
+		FontProbeCache::insert(family, probe);
 	}
 
-	if ( !fi.fixedPitch() ) {
+	if ( !probe.valid ) {
 		if ( giveErrorIfMissing ) {
 			EMSG2(e_font, name);
 		}
@@ -188,6 +199,51 @@ gui_mch_flash(int msec)
 	QApplication::alert(window, msec);
 }
 
+#ifdef FEAT_JOB_CHANNEL
+/*
+ * Channels with the keep_open flag are not registered with the GUI, they
+ * are watched only while waiting for a character.
+ */
+static QList<QSocketNotifier *> keep_open_notifiers;
+
+static void
+keep_open_activated(int fd)
+{
+	/* A disconnected channel stays readable, the notifier is enabled
+	 * again on the next wait */
+	foreach(QSocketNotifier *n, keep_open_notifiers) {
+		if ( n->socket() == fd ) {
+			n->setEnabled(false);
+		}
+	}
+
+	channel_handle_events(TRUE);
+	vimshell->wakeUp();
+}
+
+static void
+keep_open_watch(int fd)
+{
+	keep_open_notifiers.append(
+		(QSocketNotifier *)qt_socket_notifier_read(fd, keep_open_activated));
+}
+
+static void
+keep_open_watch_all()
+{
+	channel_keep_open_fds(keep_open_watch);
+}
+
+static void
+keep_open_unwatch_all()
+{
+	foreach(QSocketNotifier *n, keep_open_notifiers) {
+		qt_remove_socket_notifier(n);
+	}
+	keep_open_notifiers.clear();
+}
+#endif
+
 /*
  * GUI input routine called by gui_wait_for_chars().  Waits for a character
  * from the keyboard.
@@ -204,22 +260,42 @@ gui_mch_wait_for_chars(long wtime)
 		return OK;
 	}
 
-#ifdef FEAT_JOB_CHANNEL
-	QTimer channel_poll_timer;
-	channel_poll_timer.setInterval(20);
-	QObject::connect(&channel_poll_timer, &QTimer::timeout, []() {
-			channel_handle_events(TRUE);
-			parse_queued_messages();
-		});
+	QElapsedTimer elapsed;
+	elapsed.start();
+
+	bool ret;
+	do {
+#ifdef MESSAGE_QUEUE
+# ifdef FEAT_TIMERS
+		did_add_timer = FALSE;
+# endif
+		parse_queued_messages();
+# ifdef FEAT_TIMERS
+		if (did_add_timer) {
+			/* Need to recompute the waiting time. */
+			return FAIL;
+		}
+# endif
+		if (!vim_is_input_buf_empty()) {
+			return OK;
+		}
+#endif
 
-    /* If there is a channel with the keep_open flag we need to poll for input
-     * on them. */
-    if (channel_any_keep_open()) {
-		channel_poll_timer.start();
-	}
+		long remaining = wtime;
+		if ( wtime > 0 ) {
+			remaining = qMax(wtime - (long)elapsed.elapsed(), 1L);
+		}
+
+#ifdef FEAT_JOB_CHANNEL
+		keep_open_watch_all();
+#endif
+		ret = vimshell->processEvents(remaining, true);
+#ifdef FEAT_JOB_CHANNEL
+		keep_open_unwatch_all();
 #endif
+	} while ( !ret && (wtime < 0 || elapsed.elapsed() < wtime) );
 
-	return vimshell->processEvents(wtime, true);
+	return ret ? OK : FAIL;
 }
 
 /**
@@ -237,10 +313,14 @@ gui_mch_update()
 
 /**
  * Flush any output to the screen
+ *
+ * Shell damage is presented at most once per frame, if a frame is
+ * not yet due it will be presented when the frame timer fires
  */
 void
 gui_mch_flush()
 {
+	vimshell->flush();
 	vimshell->processEvents(0, true);
 }
 
@@ -251,7 +331,7 @@ void
 gui_mch_set_fg_color(guicolor_T	color)
 {
 	if ( color != INVALCOLOR ) {
-		foregroundColor = VimWrapper::fromColor(color);
+		foregroundColor = VimWrapper::fromColorRgb(color);
 	}
 }
 
@@ -264,7 +344,7 @@ gui_mch_set_bg_color(guicolor_T color)
 	// The shell needs a hint background color
 	// to paint the back when resizing
 	if ( color != INVALCOLOR ) {
-		backgroundColor = VimWrapper::fromColor(color);
+		backgroundColor = VimWrapper::fromColorRgb(color);
 	}
 }
 
@@ -310,10 +390,7 @@ gui_mch_beep()
 void
 gui_mch_clear_all()
 {
-	QVimShell::PaintOperation op;
-	op.type = QVimShell::CLEARALL;
-	op.color = VimWrapper::fromColor(gui.back_pixel);
-	vimshell->queuePaintOp(op);
+	vimshell->clearAll(VimWrapper::fromColorRgb(gui.back_pixel));
 }
 
 
@@ -321,18 +398,18 @@ gui_mch_clear_all()
  * Update Vim metrics
  */
 static void
-update_char_metrics(const QFontMetrics& metric)
+update_char_metrics(const FontProbe& metric)
 {
-	gui.char_width = metric.width("M");
+	gui.char_width = metric.width;
 
 	// The actual linespace plus Vim's fake linespace
-	gui.char_height = metric.lineSpacing() + p_linespace;
-	if ( metric.underlinePos() >= metric.descent() ) {
-		gui.char_height += metric.underlinePos() - metric.descent() + metric.lineWidth();
+	gui.char_height = metric.lineSpacing + p_linespace;
+	if ( metric.underlinePos >= metric.descent ) {
+		gui.char_height += metric.underlinePos - metric.descent + metric.lineWidth;
 	}
 
-	gui.char_ascent = metric.ascent() + p_linespace/2 + metric.leading();
-	gui.char_ul_pos = metric.underlinePos();
+	gui.char_ascent = metric.ascent + p_linespace/2 + metric.leading;
+	gui.char_ul_pos = metric.underlinePos;
 }
 
 /**
@@ -349,17 +426,27 @@ gui_mch_init_font(char_u *font_name, int do_fontset)
 		return FAIL;
 	}
 
-	QFontMetrics metric( *qf );
+	gui.norm_font = qf;
+	vimshell->setShellFont(*qf);
+
+	// Warm starts take the metrics from the font cache
+	QString name = VimWrapper::convertFrom(font_name);
+	if ( !FontProbeCache::lookup(name, &fontProbe) || !fontProbe.hasMetrics() ) {
+		fontProbe.valid = true;
+		fontProbe.fakeMonospace = VimWrapper::isFakeMonospace(*qf);
+		fontProbe.setMetrics(vimshell->fonts().metrics(0));
+		FontProbeCache::insert(name, fontProbe);
+	}
 
-	if ( VimWrapper::isFakeMonospace(*qf) || getenv("QVIM_DRAW_STRING_SLOW") ) {
+	if ( fontProbe.fakeMonospace || getenv("QVIM_DRAW_STRING_SLOW") ) {
 		vimshell->setSlowStringDrawing( true );
 	} else {
 		vimshell->setSlowStringDrawing( false );
 	}
 
-	gui.norm_font = qf;
-	update_char_metrics(metric);
+	update_char_metrics(fontProbe);
 	vimshell->setCharWidth(gui.char_width);
+	vimshell->update();
 
 	return OK;
 }
@@ -431,37 +518,8 @@ gui_mch_get_rgb(guicolor_T pixel)
 void
 gui_mch_clear_block(int row1, int col1, int row2, int col2)
 {
-	QRect rect = VimWrapper::mapBlock(row1, col1, row2, col2);
-
-	QVimShell::PaintOperation op;
-	op.type = QVimShell::FILLRECT;
-	op.color = VimWrapper::fromColor(gui.back_pixel);
-	op.rect = rect;
-	vimshell->queuePaintOp(op);
-}
-
-/**
- * Clear the shell margin
- *
- * The shell is a grid whose size is a multiple of its column/row size.
- * Sometimes an extra margin is in place, this paints that margin.
- */
-static void
-clear_shell_border()
-{
-	QPoint tl, br;
-
-	tl.setX(0);
-	tl.setY( vimshell->height() - (vimshell->height() % gui.char_height ));
-
-	br.setX(vimshell->width());
-	br.setY(vimshell->height());
-
-	QVimShell::PaintOperation op;
-	op.type = QVimShell::FILLRECT;
-	op.color = VimWrapper::fromColor(gui.back_pixel);
-	op.rect = QRect(tl, br);
-	vimshell->queuePaintOp(op);
+	vimshell->clearBlock(row1, col1, row2, col2,
+			VimWrapper::fromColorRgb(gui.back_pixel));
 }
 
 /**
@@ -471,17 +529,9 @@ clear_shell_border()
 void
 gui_mch_insert_lines(int row, int num_lines)
 {
-	QRect scrollRect = VimWrapper::mapBlock(row, gui.scroll_region_left,
-					gui.scroll_region_bot, gui.scroll_region_right);
-
-	QVimShell::PaintOperation op1;
-	op1.type = QVimShell::SCROLLRECT;
-	op1.rect = scrollRect;
-	op1.pos = QPoint(0, num_lines*gui.char_height);
-	op1.color = VimWrapper::fromColor(gui.back_pixel);
-	vimshell->queuePaintOp(op1);
-
-	clear_shell_border();
+	vimshell->scrollRows(row, gui.scroll_region_bot,
+			gui.scroll_region_left, gui.scroll_region_right,
+			num_lines, VimWrapper::fromColorRgb(gui.back_pixel));
 }
 
 /*
@@ -491,16 +541,9 @@ gui_mch_insert_lines(int row, int num_lines)
 void
 gui_mch_delete_lines(int row, int num_lines)
 {
-	// This used to be Bottom+1 and right+1
-	QRect scrollRect = VimWrapper::mapBlock(row, gui.scroll_region_left,
-					gui.scroll_region_bot, gui.scroll_region_right);
-
-	QVimShell::PaintOperation op;
-	op.type = QVimShell::SCROLLRECT;
-	op.rect = scrollRect;
-	op.pos = QPoint(0, -num_lines*gui.char_height);
-	op.color = VimWrapper::fromColor(gui.back_pixel);
-	vimshell->queuePaintOp(op);
+	vimshell->scrollRows(row, gui.scroll_region_bot,
+			gui.scroll_region_left, gui.scroll_region_right,
+			-num_lines, VimWrapper::fromColorRgb(gui.back_pixel));
 }
 
 
@@ -534,30 +577,45 @@ gui_mch_init()
 	bool useGUI = true;
 #endif
 	QApplication *app = new QApplication(dummy_argc, dummy_argv, useGUI);
-
+	TIME_MSG("GUI: QApplication created");
 
 	window = new MainWindow(&gui);
+	TIME_MSG("GUI: main window created");
 
 	// Load qVim settings
 	QSettings settings("Vim", "qVim");
 	settings.beginGroup("mainwindow");
 	window->restoreState( settings.value("state").toByteArray() );
 	settings.endGroup();
+	TIME_MSG("GUI: settings restored");
 
 	vimshell = window->vimShell();
 
-	// Load qVim style
-	QSettings ini(QSettings::IniFormat, QSettings::UserScope, "Vim", "qVim");
-	QFile styleFile( QFileInfo(ini.fileName()).absoluteDir().absoluteFilePath("qVim.style") );
+	// Cap the shell frame rate, by default it follows the display
+	if ( getenv("QVIM_MAX_FPS") ) {
+		vimshell->setMaxFrameRate(atoi(getenv("QVIM_MAX_FPS")));
+	}
+
+	// Threads used to rasterize large redraws, by default one per core
+	if ( getenv("QVIM_RASTER_THREADS") ) {
+		vimshell->setRasterThreads(atoi(getenv("QVIM_RASTER_THREADS")));
+	}
 
-	if ( styleFile.open(QIODevice::ReadOnly) ) {
-		window->setStyleSheet( styleFile.readAll() );
-		styleFile.close();
+	// Record the drawing calls, see DrawTrace::replay()
+	if ( getenv("QVIM_DRAW_TRACE") ) {
+		drawTrace = new DrawTrace();
+		if ( drawTrace->open(getenv("QVIM_DRAW_TRACE")) ) {
+			vimshell->setTrace(drawTrace);
+		} else {
+			delete drawTrace;
+			drawTrace = NULL;
+		}
 	}
 
 	//
 	// Hide the tab/menu/tool-bars, if needed they will become visible later.
-	// Otherwise the use might see these items when Vim is loading
+	// Otherwise the use might see these items when Vim is loading. Bars
+	// that do not exist yet are not created here.
 	//
 	window->showMenu(false);
 	window->showToolbar(false);
@@ -755,8 +813,8 @@ gui_mch_mousehide(int hide)
 int
 gui_mch_adjust_charheight()
 {
-	QFontMetrics metric( *gui.norm_font );
-	update_char_metrics(metric);
+	update_char_metrics(fontProbe);
+	vimshell->update();
 	return OK;
 }
 
@@ -794,12 +852,7 @@ gui_mch_iconify()
 void
 gui_mch_invert_rectangle(int row, int col, int nr, int nc)
 {
-	QRect rect = VimWrapper::mapBlock(row, col, row+nr-1, col +nc-1);
-
-	QVimShell::PaintOperation op;
-	op.type = QVimShell::INVERTRECT;
-	op.rect = rect;
-	vimshell->queuePaintOp(op);
+	vimshell->invertBlock(row, col, row+nr-1, col+nc-1);
 }
 
 /**
@@ -811,7 +864,16 @@ gui_mch_set_font(GuiFont font)
 	if (font == NULL) {
 		return;
 	}
-	vimshell->setFont(*font);
+
+	// Vim selects a font before drawing every string, the
+	// style variants come from the draw flags instead
+	if ( font == gui.wide_font ) {
+		vimshell->setWideFont(*font);
+		vimshell->selectWideFont(true);
+	} else {
+		vimshell->setShellFont(*font);
+		vimshell->selectWideFont(false);
+	}
 }
 
 
@@ -829,6 +891,17 @@ gui_mch_exit(int rc)
 	settings.setValue("state", window->saveState());
 	settings.endGroup();
 
+	// Dump the paint counters for offline analysis
+	if ( getenv("QVIM_PROFILE") ) {
+		qt_profile_dump(getenv("QVIM_PROFILE"));
+	}
+
+	if ( drawTrace ) {
+		vimshell->setTrace(NULL);
+		delete drawTrace;
+		drawTrace = NULL;
+	}
+
 	QApplication::quit();
 }
 
@@ -868,37 +941,19 @@ clip_mch_lose_selection(VimClipboard *cbd)
 
 /**
  * Send the current selection to the clipboard
+ *
+ * The selection is converted when someone asks for it, see VimMimeData
  */
 void
 clip_mch_set_selection(VimClipboard *cbd)
 {
-	long_u size;
-	char_u *str = NULL;
-
 	if (!cbd->owned) {
 		return;
 	}
-
-	cbd->owned = TRUE;
-	clip_get_selection(cbd);
 	cbd->owned = FALSE;
 
-	int type = clip_convert_selection(&str, (long_u *)&size, cbd);
-	if (type >= 0) {
-		// Serialize the motion type and store it into the clipboard
-		// with a mimetype application/x-vim-qt-selection-type
-		QByteArray payload;
-		QDataStream serialize(&payload, QIODevice::WriteOnly);
-		serialize << type;
-
-		QClipboard *clip = QApplication::clipboard();
-		QMimeData *clipData = new QMimeData();
-		clipData->setText(VimWrapper::convertFrom(str, size));
-		clipData->setData("application/x-vim-qt-selection-type", payload);
-
-		clip->setMimeData(clipData, (QClipboard::Mode)cbd->clipboardMode);
-	}
-	vim_free(str);
+	QClipboard *clip = QApplication::clipboard();
+	clip->setMimeData(new VimMimeData(cbd), (QClipboard::Mode)cbd->clipboardMode);
 }
 
 /**
@@ -909,11 +964,29 @@ void
 clip_mch_request_selection(VimClipboard *cbd)
 {
 	QClipboard *clip = QApplication::clipboard();
-	if ( clip->text((QClipboard::Mode)cbd->clipboardMode).size() == 0 ) {
+	const QMimeData *data = clip->mimeData((QClipboard::Mode)cbd->clipboardMode);
+	if ( !data ) {
 		return;
 	}
 
-	QByteArray text = VimWrapper::convertTo(clip->text( (QClipboard::Mode)cbd->clipboardMode));
+	QByteArray text;
+	int type = MAUTO;
+
+	// Our own selection is already in Vim's encoding
+	const VimMimeData *own = dynamic_cast<const VimMimeData *>(data);
+	if ( own ) {
+		if ( !own->selection(text, type) ) {
+			return;
+		}
+	} else {
+		text = VimWrapper::convertTo(data->text());
+
+		// If available, deserialize the motion type from the clipboard
+		if ( data->hasFormat(VimMimeData::SelectionTypeMime) ) {
+			QDataStream serialize(data->data(VimMimeData::SelectionTypeMime));
+			serialize >> type;
+		}
+	}
 
 	if ( text.isEmpty() ) {
 		// This should not happen, but if it does vim
@@ -921,24 +994,9 @@ clip_mch_request_selection(VimClipboard *cbd)
 		return;
 	}
 
-	char_u	*buffer;
-	buffer = lalloc( text.size(), TRUE);
-	if (buffer == NULL)
-		return;
-
-	for (int i = 0; i < text.size(); ++i) {
-		buffer[i] = text[i];
-	}
-
-	int type = MAUTO;
-	// If available, deserialize the motion type from the clipboard
-	if (clip->mimeData((QClipboard::Mode)cbd->clipboardMode)->hasFormat("application/x-vim-qt-selection-type")) {
-		QDataStream serialize(clip->mimeData((QClipboard::Mode)cbd->clipboardMode)->data("application/x-vim-qt-selection-type"));
-		serialize >> type;
-	}
-
-	clip_yank_selection(type, buffer, text.size(), cbd);
-	vim_free(buffer);
+	// The register is filled straight from the text, Vim does
+	// not write into it
+	clip_yank_selection(type, (char_u *)text.constData(), text.size(), cbd);
 }
 
 /**
@@ -955,6 +1013,23 @@ gui_mch_open()
     	if (gui_win_x != -1 && gui_win_y != -1) {
 		gui_mch_set_winpos(gui_win_x, gui_win_y);
 	}
+	TIME_MSG("GUI: window shown");
+
+	// The qVim style is loaded once the event loop runs, after
+	// the first frame
+	QTimer::singleShot(0, window, SLOT(loadStyleSheet()));
+
+	// Benchmark mode, replay a trace into the shell and quit
+	if ( getenv("QVIM_DRAW_REPLAY") ) {
+		QString report = DrawTrace::replay(getenv("QVIM_DRAW_REPLAY"), vimshell);
+		if ( report.isEmpty() ) {
+			fprintf(stderr, "qvim: invalid draw trace %s\n", getenv("QVIM_DRAW_REPLAY"));
+			mch_exit(1);
+		}
+		fputs(report.toUtf8().constData(), stdout);
+		fflush(stdout);
+		mch_exit(0);
+	}
 
 	return OK;
 }
@@ -974,11 +1049,7 @@ gui_mch_draw_hollow_cursor(guicolor_T color)
 			FILL_Y(gui.row)+gui.char_height-2);
 	QRect rect(tl, br);
 
-	QVimShell::PaintOperation op;
-	op.type = QVimShell::DRAWRECT;
-	op.rect = rect;
-	op.color = VimWrapper::fromColor(color);
-	vimshell->queuePaintOp(op);
+	vimshell->drawHollowCursor(rect, VimWrapper::fromColorRgb(color));
 }
 
 /**
@@ -1001,11 +1072,7 @@ gui_mch_draw_part_cursor(int w, int h, guicolor_T color)
 
 	QRect rect( x, y, w, h);
 
-	QVimShell::PaintOperation op;
-	op.type = QVimShell::FILLRECT;
-	op.rect = rect;
-	op.color = VimWrapper::fromColor(color);
-	vimshell->queuePaintOp(op);
+	vimshell->drawPartCursor(rect, VimWrapper::fromColorRgb(color));
 }
 
 /**
@@ -1015,7 +1082,7 @@ void
 gui_mch_set_sp_color(guicolor_T color)
 {
 	if ( color != INVALCOLOR ) {
-		specialColor = VimWrapper::fromColor(color);
+		specialColor = VimWrapper::fromColorRgb(color);
 	}
 }
 
@@ -1031,48 +1098,8 @@ gui_mch_draw_string(
     int		flags)
 {
 	QString str = VimWrapper::convertFrom(s, len);
-
-	// Font
-	QFont f = vimshell->font();
-	f.setBold( flags & DRAW_BOLD);
-	f.setUnderline( flags & DRAW_UNDERL);
-	f.setItalic( flags & DRAW_ITALIC);
-
-	QFontMetrics fm(f);
-
-	int cellwidth = VimWrapper::stringCellWidth(str);
-	QPoint pos = VimWrapper::mapText(row, col);
-	QRect rect( pos.x(), pos.y(), gui.char_width*cellwidth, gui.char_height);
-
-	if (flags & DRAW_TRANSP) {
-		// Do we need to do anything?
-	} else {
-		// Fill in the background
-		QVimShell::PaintOperation op;
-		op.type = QVimShell::FILLRECT;
-		op.rect = rect;
-		op.color = backgroundColor;
-		vimshell->queuePaintOp(op);
-	}
-
-	// Remove upper linespace from rect
-	QRect rect_text( pos.x(), pos.y() + p_linespace/2, gui.char_width*cellwidth, gui.char_height);
-	QVimShell::PaintOperation op;
-	op.type = QVimShell::DRAWSTRING;
-	op.font = f;
-	op.rect = rect_text;
-	op.str = str;
-	op.color = foregroundColor;
-	op.undercurl = flags & DRAW_UNDERC;
-	if ( op.undercurl ) { // FIXME: Refactor QVimShell::PaintOperation
-		op.curlcolor = specialColor;
-	}
-
-	// op.pos is the text baseline
-	op.pos = rect.topLeft();
-	op.pos.setY( op.pos.y() + gui.char_ascent );
-
-	vimshell->queuePaintOp(op);
+	vimshell->drawString(row, col, str, flags, foregroundColor,
+			backgroundColor, specialColor);
 }
 
 
@@ -1086,6 +1113,12 @@ gui_mch_get_color(char_u *reqname)
 	if ( reqname == NULL ) {
 		return INVALCOLOR;
 	}
+	QRgb rgb;
+	if ( ColorTable::lookup((const char *)reqname, &rgb) ) {
+		return rgb & 0x00FFFFFF;
+	}
+
+	// Other names Qt knows about
 	QColor c = vimshell->color(VimWrapper::convertFrom(reqname));
 	if ( c.isValid() ) {
 		return VimWrapper::toColor(c);
@@ -1101,8 +1134,7 @@ gui_mch_get_color(char_u *reqname)
 guicolor_T
 gui_mch_get_rgb_color(int r, int g, int b)
 {
-    QColor c = QColor(r, g, b);
-    return VimWrapper::toColor(c);
+    return ((guicolor_T)r << 16) | ((guicolor_T)g << 8) | b;
 }
 
 /**
@@ -1406,6 +1438,11 @@ gui_mch_def_colors()
 void
 gui_mch_set_scrollbar_thumb(scrollbar_T *sb, long val, long size, long max)
 {
+	if ( sb->wid->value() == val && sb->wid->maximum() == max
+			&& sb->wid->pageStep() == size ) {
+		return;
+	}
+
 	sb->wid->setValue(val);
 	sb->wid->setMaximum(max);
 	sb->wid->setPageStep(size);
@@ -1656,6 +1693,7 @@ gui_mch_update_tabline(void)
 	tabpage_T *tp;
 	int current = 0;
 	int nr = 0;
+	QStringList labels;
 
 	for (tp = first_tabpage; tp != NULL; tp = tp->tp_next, nr++)
 	{
@@ -1665,11 +1703,12 @@ gui_mch_update_tabline(void)
 
 		get_tabline_label(tp, FALSE);
 		char_u *labeltext = CONVERT_TO_UTF8(NameBuff);
-		window->setTab( nr, VimWrapper::convertFrom(labeltext));
+		labels.append(VimWrapper::convertFrom(labeltext));
 		CONVERT_TO_UTF8_FREE(labeltext);
 	}
-	window->removeTabs(nr);
-	window->setCurrentTab(current);
+
+	// Only the changed tabs are updated
+	window->setTabs(labels, current);
 }
 
 /**
@@ -1733,23 +1772,11 @@ out:
 void
 gui_mch_drawsign(int row, int col, int typenr)
 {
-	QIcon *icon = (QIcon *)sign_get_image(typenr);
-	if ( !icon ) {
+	if ( !sign_get_image(typenr) ) {
 		return;
 	}
 
-	QPoint pos = VimWrapper::mapText(row, col);
-	QVimShell::PaintOperation op;
-	op.type = QVimShell::DRAWSIGN;
-	op.pos = pos;
-	op.sign = icon->pixmap( VimWrapper::charWidth()*2, VimWrapper::charHeight() );
-	op.rect = QRect(pos, QSize(VimWrapper::charWidth()*2, VimWrapper::charHeight()));
-
-	if (op.sign.isNull()) {
-		// FIXME: this should not happen
-		return;
-	}
-	vimshell->queuePaintOp(op);
+	vimshell->drawSign(row, col, typenr);
 }
 
 
@@ -1760,7 +1787,7 @@ void
 gui_mch_destroy_sign(void *sign)
 {
 	if ( sign ) {
-		delete (QIcon*)sign;
+		delete (SignIcon*)sign;
 	}
 }
 
@@ -1798,7 +1825,7 @@ gui_mch_register_sign(char_u *signfile)
 		return NULL;
 	}
 
-	return new QIcon(icon);
+	return new SignIcon(icon);
 }
 
 void * qt_socket_notifier_read(int fd, void (fptr)(int))
@@ -1819,6 +1846,115 @@ void * qt_socket_notifier_ex(int fd, void (fptr)(int))
 	return err;
 }
 
+#ifdef FEAT_EVAL
+/*
+ * Add a histogram to a dictionary, as a dictionary with the
+ * sample count, total, maximum and bucket counts/limits
+ */
+static void
+qt_profile_add_histogram(dict_T *d, const char *key, const Histogram& h)
+{
+	dict_T *hd = dict_alloc();
+	list_T *buckets = list_alloc();
+	list_T *limits = list_alloc();
+	if ( hd == NULL || buckets == NULL || limits == NULL ) {
+		if ( hd ) {
+			dict_unref(hd);
+		}
+		if ( buckets ) {
+			list_unref(buckets);
+		}
+		if ( limits ) {
+			list_unref(limits);
+		}
+		return;
+	}
+
+	for (int i=0; i<Histogram::Buckets; i++) {
+		list_append_number(buckets, h.bucket(i));
+		list_append_number(limits, h.limit(i));
+	}
+	dict_add_nr_str(hd, (char *)"count", h.count(), NULL);
+	dict_add_nr_str(hd, (char *)"total", h.total(), NULL);
+	dict_add_nr_str(hd, (char *)"max", h.max(), NULL);
+	dict_add_list(hd, (char *)"buckets", buckets);
+	dict_add_list(hd, (char *)"limits", limits);
+	dict_add_dict(d, (char *)key, hd);
+}
+#endif
+
+/*
+ * Text report of the paint counters
+ */
+static QString
+qt_profile_report()
+{
+	const PaintStats& stats = vimshell->stats();
+	QString report;
+	report += QString("frames %1 rows %2 cells %3\n")
+			.arg(stats.frames()).arg(stats.rows()).arg(stats.cells());
+	report += "frame_us " + stats.frameTime().toString() + "\n";
+	report += "cells_per_frame " + stats.cellsPerFrame().toString() + "\n";
+	report += "input_latency_us " + stats.inputLatency().toString() + "\n";
+	report += QString("glyph_cache hits %1 misses %2\n")
+			.arg(vimshell->glyphs().hits()).arg(vimshell->glyphs().misses());
+	report += QString("font_cache hits %1 misses %2\n")
+			.arg(vimshell->fonts().hits()).arg(vimshell->fonts().misses());
+	return report;
+}
+
+static bool
+qt_profile_dump(const QString& fname)
+{
+	QFile f(fname);
+	if ( !f.open(QIODevice::WriteOnly | QIODevice::Text) ) {
+		return false;
+	}
+	f.write(qt_profile_report().toUtf8());
+	return true;
+}
+
+#ifdef FEAT_EVAL
+/**
+ * Fill "d" with the paint pipeline counters, used by guiprofile().
+ * If "fname" is not NULL the report is also written to that file.
+ */
+void
+gui_mch_profile(dict_T *d, char_u *fname)
+{
+	if ( vimshell == NULL ) {
+		return;
+	}
+
+	PaintStats& stats = vimshell->stats();
+	dict_add_nr_str(d, (char *)"frames", stats.frames(), NULL);
+	dict_add_nr_str(d, (char *)"rows", stats.rows(), NULL);
+	dict_add_nr_str(d, (char *)"cells", stats.cells(), NULL);
+	qt_profile_add_histogram(d, "frame_us", stats.frameTime());
+	qt_profile_add_histogram(d, "cells_per_frame", stats.cellsPerFrame());
+	qt_profile_add_histogram(d, "input_latency_us", stats.inputLatency());
+	dict_add_nr_str(d, (char *)"glyph_hits", vimshell->glyphs().hits(), NULL);
+	dict_add_nr_str(d, (char *)"glyph_misses", vimshell->glyphs().misses(), NULL);
+	dict_add_nr_str(d, (char *)"font_hits", vimshell->fonts().hits(), NULL);
+	dict_add_nr_str(d, (char *)"font_misses", vimshell->fonts().misses(), NULL);
+
+	if ( fname != NULL && !qt_profile_dump(VimWrapper::convertFrom(fname)) ) {
+		EMSG2(_(e_notopen), fname);
+	}
+}
+#endif
+
+/**
+ * Interrupt gui_mch_wait_for_chars(), e.g. when a channel
+ * has messages waiting to be parsed
+ */
+void qt_interrupt_wait(void)
+{
+	if ( vimshell ) {
+		vimshell->wakeUp();
+	}
+}
+
 void qt_remove_socket_notifier(void *inp)
 {
 	if (inp == NULL) {
@@ -65,10 +65,55 @@ extern int dos2;			/* this is in os_amiga.c */
 # endif
 #endif
 
+#ifdef FEAT_SWAP_THREAD
+# include <pthread.h>
+#endif
+
 #define MEMFILE_PAGE_SIZE 4096		/* default page size */
 
 static long_u	total_mem_used = 0;	/* total memory used for memfiles */
 
+#ifdef FEAT_SWAP_THREAD
+/*
+ * When syncing with MFS_ASYNC the dirty blocks are copied into a queue and
+ * written by a separate thread, so that a slow file system does not delay
+ * typing.  Everything else that accesses the swap file first waits for the
+ * queued writes of that memfile to finish, that also keeps them in order.
+ *
+ * The writer thread only does write(), fsync() and sync(), the jobs are freed
+ * by the main thread.  The variables here, except "mf_writer_state", are
+ * protected by "mf_job_mutex", as are "mf_jobs" and "mf_job_error" in the
+ * memfiles.
+ *
+ * When preserving files for a deadly signal the main thread may have been
+ * holding the mutex, or the writer may be stuck.  Then the mutex and the
+ * queue are only waited for a limited time and blocks are written directly.
+ */
+typedef struct mf_job_S mf_job_T;
+
+struct mf_job_S
+{
+    mf_job_T	*mj_next;
+    memfile_T	*mj_mfp;	/* memfile the job is for */
+    int		mj_fd;		/* file to write or fsync(), -1 for sync() */
+    char_u	*mj_data;	/* data to write, NULL for fsync() */
+    off_T	mj_offset;	/* where to write it */
+    unsigned	mj_size;	/* number of bytes in "mj_data" */
+};
+
+# define MF_JOB_MAX_BYTES   (1024L * 1024L)  /* max. size of queued data */
+# define MF_JOB_EXIT_WAIT   2		    /* seconds to wait when exiting */
+
+static pthread_mutex_t	mf_job_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t	mf_job_added = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t	mf_job_done = PTHREAD_COND_INITIALIZER;
+static mf_job_T		*mf_job_first = NULL;	/* queued jobs */
+static mf_job_T		*mf_job_last = NULL;
+static mf_job_T		*mf_job_free = NULL;	/* jobs done, to be freed */
+static long		mf_job_bytes = 0;	/* bytes queued or writing */
+static int		mf_writer_state = 0;	/* 1: running, -1: can't start */
+#endif
+
 static void mf_ins_hash(memfile_T *, bhdr_T *);
 static void mf_rem_hash(memfile_T *, bhdr_T *);
 static bhdr_T *mf_find_hash(memfile_T *, blocknr_T);
@@ -78,10 +123,22 @@ static bhdr_T *mf_release(memfile_T *, int);
 static bhdr_T *mf_alloc_bhdr(memfile_T *, int);
 static void mf_free_bhdr(bhdr_T *);
 static void mf_ins_free(memfile_T *, bhdr_T *);
+#ifdef FEAT_LAZYREAD
+static lazyblock_T *mf_lazyblock(memfile_T *mfp, blocknr_T nr);
+static void mf_claim(memfile_T *mfp, bhdr_T *hp);
+#endif
 static bhdr_T *mf_rem_free(memfile_T *);
 static int  mf_read(memfile_T *, bhdr_T *);
-static int  mf_write(memfile_T *, bhdr_T *);
-static int  mf_write_block(memfile_T *mfp, bhdr_T *hp, off_T offset, unsigned size);
+static int  mf_write(memfile_T *, bhdr_T *, int);
+static int  mf_write_block(memfile_T *mfp, bhdr_T *hp, off_T offset, unsigned size, int async);
+#ifdef FEAT_SWAP_THREAD
+static int mf_job_add(memfile_T *mfp, int fd, char_u *data, off_T offset, unsigned size);
+static void mf_job_free_list(mf_job_T *job);
+static int mf_job_lock(void);
+static int mf_job_wait(pthread_cond_t *cond, time_t deadline);
+static void mf_job_check(memfile_T *mfp, int wait);
+static void *mf_writer(void *arg);
+#endif
 static int  mf_trans_add(memfile_T *, bhdr_T *);
 static void mf_do_open(memfile_T *, char_u *, int);
 static void mf_hash_init(mf_hashtab_T *);
@@ -155,10 +212,17 @@ mf_open(char_u *fname, int flags)
     mfp->mf_used_first = NULL;		/* used list is empty */
     mfp->mf_used_last = NULL;
     mfp->mf_dirty = FALSE;
+#ifdef FEAT_SWAP_THREAD
+    mfp->mf_jobs = 0;
+    mfp->mf_job_error = FALSE;
+#endif
     mfp->mf_used_count = 0;
     mf_hash_init(&mfp->mf_hash);
     mf_hash_init(&mfp->mf_trans);
     mfp->mf_page_size = MEMFILE_PAGE_SIZE;
+#ifdef FEAT_LAZYREAD
+    mfp->mf_mapped = NULL;
+#endif
 #ifdef FEAT_CRYPT
     mfp->mf_old_key = NULL;
 #endif
@@ -242,6 +306,9 @@ mf_close(memfile_T *mfp, int del_file)
 
     if (mfp == NULL)		    /* safety check */
 	return;
+#ifdef FEAT_SWAP_THREAD
+    mf_sync_wait(mfp);
+#endif
     if (mfp->mf_fd >= 0)
     {
 	if (close(mfp->mf_fd) < 0)
@@ -260,6 +327,9 @@ mf_close(memfile_T *mfp, int del_file)
 	vim_free(mf_rem_free(mfp));
     mf_hash_free(&mfp->mf_hash);
     mf_hash_free_all(&mfp->mf_trans);	    /* free hashtable and its items */
+#ifdef FEAT_LAZYREAD
+    mf_unmap(mfp);
+#endif
     vim_free(mfp->mf_fname);
     vim_free(mfp->mf_ffname);
     vim_free(mfp);
@@ -290,6 +360,9 @@ mf_close_file(
 	/* TODO: should check if all blocks are really in core */
     }
 
+#ifdef FEAT_SWAP_THREAD
+    mf_sync_wait(mfp);
+#endif
     if (close(mfp->mf_fd) < 0)			/* close the file */
 	EMSG(_(e_swapclose));
     mfp->mf_fd = -1;
@@ -426,7 +499,11 @@ mf_get(memfile_T *mfp, blocknr_T nr, int page_count)
     hp = mf_find_hash(mfp, nr);
     if (hp == NULL)	/* not in the hash list */
     {
-	if (nr < 0 || nr >= mfp->mf_infile_count)   /* can't be in the file */
+	if ((nr < 0 || nr >= mfp->mf_infile_count)  /* can't be in the file */
+#ifdef FEAT_LAZYREAD
+		&& mf_lazyblock(mfp, nr) == NULL	    /* and not mapped */
+#endif
+		)
 	    return NULL;
 
 	/* could check here if the block is in the free list */
@@ -443,6 +520,15 @@ mf_get(memfile_T *mfp, blocknr_T nr, int page_count)
 	hp->bh_bnum = nr;
 	hp->bh_flags = 0;
 	hp->bh_page_count = page_count;
+#ifdef FEAT_LAZYREAD
+	if (nr < 0)			    /* make it from the mapped text */
+	{
+	    /* When the text is gone keep the block like a changed one. */
+	    if (ml_fill_mapped(mfp, hp) == FAIL)
+		mf_claim(mfp, hp);
+	}
+	else
+#endif
 	if (mf_read(mfp, hp) == FAIL)	    /* cannot read the block! */
 	{
 	    mf_free_bhdr(hp);
@@ -490,6 +576,10 @@ mf_put(
 	mfp->mf_dirty = TRUE;
     }
     hp->bh_flags = flags;
+#ifdef FEAT_LAZYREAD
+    if (dirty)
+	mf_claim(mfp, hp);
+#endif
     if (infile)
 	mf_trans_add(mfp, hp);	    /* may translate negative in positive nr */
 }
@@ -505,6 +595,9 @@ mf_free(memfile_T *mfp, bhdr_T *hp)
     mf_rem_used(mfp, hp);	/* get *hp out of the used list */
     if (hp->bh_bnum < 0)
     {
+#ifdef FEAT_LAZYREAD
+	mf_claim(mfp, hp);	/* counted below */
+#endif
 	vim_free(hp);		/* don't want negative numbers in free list */
 	mfp->mf_neg_count--;
     }
@@ -533,6 +626,8 @@ fdtofh(int filedescriptor)
  *  MFS_FLUSH	Make sure buffers are flushed to disk, so they will survive a
  *		system crash.
  *  MFS_ZERO	Only write block 0.
+ *  MFS_ASYNC	Write the blocks in the writer thread when possible.  Write
+ *		errors are reported by a later call.
  *
  * Return FAIL for failure, OK otherwise
  */
@@ -545,6 +640,7 @@ mf_sync(memfile_T *mfp, int flags)
     int		fd;
 #endif
     int		got_int_save = got_int;
+    int		async = FALSE;
 
     if (mfp->mf_fd < 0)	    /* there is no file, nothing to do */
     {
@@ -552,6 +648,18 @@ mf_sync(memfile_T *mfp, int flags)
 	return FAIL;
     }
 
+#ifdef FEAT_SWAP_THREAD
+    /* When using the writer thread report errors of previous writes,
+     * otherwise the queued writes must be done before writing here. */
+    if ((flags & MFS_ASYNC) && mf_writer_state >= 0)
+    {
+	mf_job_check(mfp, FALSE);
+	async = TRUE;
+    }
+    else
+	mf_sync_wait(mfp);
+#endif
+
     /* Only a CTRL-C while writing will break us here, not one typed
      * previously. */
     got_int = FALSE;
@@ -571,7 +679,7 @@ mf_sync(memfile_T *mfp, int flags)
 	{
 	    if ((flags & MFS_ZERO) && hp->bh_bnum != 0)
 		continue;
-	    if (mf_write(mfp, hp) == FAIL)
+	    if (mf_write(mfp, hp, async) == FAIL)
 	    {
 		if (status == FAIL)	/* double error: quit syncing */
 		    break;
@@ -598,6 +706,12 @@ mf_sync(memfile_T *mfp, int flags)
 
     if ((flags & MFS_FLUSH) && *p_sws != NUL)
     {
+#ifdef FEAT_SWAP_THREAD
+	if (async && mf_job_add(mfp, STRCMP(p_sws, "fsync") == 0
+				 ? mfp->mf_fd : -1, NULL, (off_T)0, 0) == OK)
+	    ;	/* the writer thread does it after the writes */
+	else
+#endif
 #if defined(UNIX)
 # ifdef HAVE_FSYNC
 	/*
@@ -805,17 +919,32 @@ mf_release(memfile_T *mfp, int page_count)
 
     /*
      * don't release a block if
-     *	there is no file for this memfile
+     *	there is no file for this memfile (unless blocks can be made again
+     *	from a mapped file)
      * or
      *	the number of blocks for this memfile is lower than the maximum
      *	  and
      *	total memory used is not up to 'maxmemtot'
      */
-    if (mfp->mf_fd < 0 || !need_release)
+    if ((mfp->mf_fd < 0
+#ifdef FEAT_LAZYREAD
+		&& mfp->mf_mapped == NULL
+#endif
+		) || !need_release)
 	return NULL;
 
+#ifdef FEAT_SWAP_THREAD
+    /* A released block may be read back, it must have been written. */
+    mf_sync_wait(mfp);
+#endif
+
     for (hp = mfp->mf_used_last; hp != NULL; hp = hp->bh_prev)
-	if (!(hp->bh_flags & BH_LOCKED))
+	if (!(hp->bh_flags & BH_LOCKED)
+#ifdef FEAT_LAZYREAD
+		&& (mfp->mf_fd >= 0 || (!(hp->bh_flags & BH_DIRTY)
+				     && mf_lazyblock(mfp, hp->bh_bnum) != NULL))
+#endif
+		)
 	    break;
     if (hp == NULL)	/* not a single one that can be released */
 	return NULL;
@@ -824,7 +953,7 @@ mf_release(memfile_T *mfp, int page_count)
      * If the block is dirty, write it.
      * If the write fails we don't free it.
      */
-    if ((hp->bh_flags & BH_DIRTY) && mf_write(mfp, hp) == FAIL)
+    if ((hp->bh_flags & BH_DIRTY) && mf_write(mfp, hp, FALSE) == FAIL)
 	return NULL;
 
     mf_rem_used(mfp, hp);
@@ -873,11 +1002,14 @@ mf_release_all(void)
 	    /* only if there is a swapfile */
 	    if (mfp->mf_fd >= 0)
 	    {
+#ifdef FEAT_SWAP_THREAD
+		mf_sync_wait(mfp);
+#endif
 		for (hp = mfp->mf_used_last; hp != NULL; )
 		{
 		    if (!(hp->bh_flags & BH_LOCKED)
 			    && (!(hp->bh_flags & BH_DIRTY)
-				|| mf_write(mfp, hp) != FAIL))
+				|| mf_write(mfp, hp, FALSE) != FAIL))
 		    {
 			mf_rem_used(mfp, hp);
 			mf_rem_hash(mfp, hp);
@@ -990,11 +1122,12 @@ mf_read(memfile_T *mfp, bhdr_T *hp)
 
 /*
  * write a block to disk
+ * When "async" is TRUE the writer thread is used.
  *
  * Return FAIL for failure, OK otherwise
  */
     static int
-mf_write(memfile_T *mfp, bhdr_T *hp)
+mf_write(memfile_T *mfp, bhdr_T *hp, int async)
 {
     off_T	offset;	    /* offset in the file */
     blocknr_T	nr;	    /* block nr which is being written */
@@ -1030,7 +1163,7 @@ mf_write(memfile_T *mfp, bhdr_T *hp)
 	    hp2 = hp;
 
 	offset = (off_T)page_size * nr;
-	if (vim_lseek(mfp->mf_fd, offset, SEEK_SET) != offset)
+	if (!async && vim_lseek(mfp->mf_fd, offset, SEEK_SET) != offset)
 	{
 	    PERROR(_("E296: Seek error in swap file write"));
 	    return FAIL;
@@ -1040,7 +1173,8 @@ mf_write(memfile_T *mfp, bhdr_T *hp)
 	else
 	    page_count = hp2->bh_page_count;
 	size = page_size * page_count;
-	if (mf_write_block(mfp, hp2 == NULL ? hp : hp2, offset, size) == FAIL)
+	if (mf_write_block(mfp, hp2 == NULL ? hp : hp2, offset, size, async)
+								      == FAIL)
 	{
 	    /*
 	     * Avoid repeating the error message, this mostly happens when the
@@ -1068,6 +1202,8 @@ mf_write(memfile_T *mfp, bhdr_T *hp)
 /*
  * Write block "hp" with data size "size" to file "mfp->mf_fd".
  * Takes care of encryption.
+ * When "async" is TRUE the writer thread writes a copy of the data at
+ * "offset", otherwise the file position must already be at "offset".
  * Return FAIL or OK.
  */
     static int
@@ -1075,7 +1211,8 @@ mf_write_block(
     memfile_T	*mfp,
     bhdr_T	*hp,
     off_T	offset UNUSED,
-    unsigned	size)
+    unsigned	size,
+    int		async UNUSED)
 {
     char_u	*data = hp->bh_data;
     int		result = OK;
@@ -1090,6 +1227,27 @@ mf_write_block(
     }
 #endif
 
+#ifdef FEAT_SWAP_THREAD
+    if (async)
+    {
+	char_u	*copy = data;
+
+	/* The writer thread gets its own copy of the data, it is freed when
+	 * the write is done. */
+	if (copy == hp->bh_data && (copy = alloc(size)) != NULL)
+	    mch_memmove(copy, data, (size_t)size);
+	if (copy != NULL
+		&& mf_job_add(mfp, mfp->mf_fd, copy, offset, size) == OK)
+	    return OK;
+	if (copy != data)
+	    vim_free(copy);
+
+	/* Can't use the writer thread, write it here. */
+	if (vim_lseek(mfp->mf_fd, offset, SEEK_SET) != offset)
+	    result = FAIL;
+    }
+    if (result == OK)
+#endif
     if ((unsigned)write_eintr(mfp->mf_fd, data, size) != size)
 	result = FAIL;
 
@@ -1120,6 +1278,11 @@ mf_trans_add(memfile_T *mfp, bhdr_T *hp)
     if ((np = (NR_TRANS *)alloc((unsigned)sizeof(NR_TRANS))) == NULL)
 	return FAIL;
 
+#ifdef FEAT_LAZYREAD
+    /* The block is going to be in the swap file, it must be written. */
+    mf_claim(mfp, hp);
+#endif
+
 /*
  * Get a new number for the block.
  * If the first item in the free list has sufficient pages, use its number
@@ -1191,6 +1354,309 @@ mf_trans_del(memfile_T *mfp, blocknr_T old_nr)
     return new_bnum;
 }
 
+#if defined(FEAT_LAZYREAD) || defined(PROTO)
+/*
+ * Return the entry for block "nr" when it is a block of a lazily read file
+ * that was not changed, NULL otherwise.
+ */
+    static lazyblock_T *
+mf_lazyblock(memfile_T *mfp, blocknr_T nr)
+{
+    lazyfile_T	*mm = mfp->mf_mapped;
+    lazyblock_T	*mb;
+
+    if (mm == NULL || nr > mm->mm_first || nr <= mm->mm_first - mm->mm_count)
+	return NULL;
+    mb = &mm->mm_blocks[mm->mm_first - nr];
+    return mb->mb_mapped ? mb : NULL;
+}
+
+/*
+ * Block "hp" is going to differ from the text in the mapped file: from now on
+ * it is kept like any other block with a negative number.
+ */
+    static void
+mf_claim(memfile_T *mfp, bhdr_T *hp)
+{
+    lazyblock_T	*mb = mf_lazyblock(mfp, hp->bh_bnum);
+
+    if (mb == NULL)
+	return;
+    mb->mb_mapped = FALSE;
+    hp->bh_flags |= BH_DIRTY;
+    mfp->mf_dirty = TRUE;
+    mfp->mf_neg_count++;
+}
+
+/*
+ * Remove the mapping of a lazily read file.  All blocks that are still made
+ * from the mapped text must have been claimed before.
+ */
+    void
+mf_unmap(memfile_T *mfp)
+{
+    lazyfile_T	*mm = mfp->mf_mapped;
+
+    if (mm == NULL)
+	return;
+    (void)munmap(mm->mm_base, (size_t)mm->mm_len);
+    vim_free(mm->mm_blocks);
+    vim_free(mm);
+    mfp->mf_mapped = NULL;
+}
+#endif
+
+#if defined(FEAT_SWAP_THREAD) || defined(PROTO)
+/*
+ * Add a job for the writer thread, starting the thread when needed.  "data"
+ * is freed when the job is done.  Waits while too much data is queued.
+ * Returns FAIL when the writer thread can't be used, then the caller must do
+ * the work itself.
+ */
+    static int
+mf_job_add(
+    memfile_T	*mfp,
+    int		fd,
+    char_u	*data,
+    off_T	offset,
+    unsigned	size)
+{
+    mf_job_T	*job;
+    mf_job_T	*done;
+
+    if (really_exiting)
+    {
+	/* Exiting for a deadly signal: write directly, after what was queued
+	 * before. */
+	mf_sync_wait(mfp);
+	return FAIL;
+    }
+    if (mf_writer_state == 0)
+    {
+	pthread_t	thread;
+	sigset_t	all, old;
+
+	/* Signals must be handled by the main thread. */
+	sigfillset(&all);
+	pthread_sigmask(SIG_SETMASK, &all, &old);
+	if (pthread_create(&thread, NULL, mf_writer, NULL) == 0)
+	{
+	    pthread_detach(thread);
+	    mf_writer_state = 1;
+	}
+	else
+	    mf_writer_state = -1;
+	pthread_sigmask(SIG_SETMASK, &old, NULL);
+    }
+    if (mf_writer_state < 0)
+	return FAIL;
+
+    job = (mf_job_T *)alloc((unsigned)sizeof(mf_job_T));
+    if (job == NULL)
+    {
+	/* The caller writes, the queued writes must be done first. */
+	mf_sync_wait(mfp);
+	return FAIL;
+    }
+    job->mj_next = NULL;
+    job->mj_mfp = mfp;
+    job->mj_fd = fd;
+    job->mj_data = data;
+    job->mj_offset = offset;
+    job->mj_size = size;
+
+    pthread_mutex_lock(&mf_job_mutex);
+    while (mf_job_bytes > 0 && mf_job_bytes + size > MF_JOB_MAX_BYTES)
+	pthread_cond_wait(&mf_job_done, &mf_job_mutex);
+    if (mf_job_last == NULL)
+	mf_job_first = job;
+    else
+	mf_job_last->mj_next = job;
+    mf_job_last = job;
+    mf_job_bytes += size;
+    ++mfp->mf_jobs;
+    pthread_cond_signal(&mf_job_added);
+    done = mf_job_free;
+    mf_job_free = NULL;
+    pthread_mutex_unlock(&mf_job_mutex);
+
+    mf_job_free_list(done);
+    return OK;
+}
+
+/*
+ * Free the list of jobs "job" that were done by the writer thread.
+ */
+    static void
+mf_job_free_list(mf_job_T *job)
+{
+    mf_job_T	*next;
+
+    for ( ; job != NULL; job = next)
+    {
+	next = job->mj_next;
+	vim_free(job->mj_data);
+	vim_free(job);
+    }
+}
+
+/*
+ * Lock "mf_job_mutex".  When exiting for a deadly signal the signal may have
+ * interrupted the main thread while it was holding the mutex, then only try
+ * for a while.  Returns FAIL when the mutex could not be locked.
+ */
+    static int
+mf_job_lock(void)
+{
+    int		i;
+
+    if (!really_exiting)
+    {
+	pthread_mutex_lock(&mf_job_mutex);
+	return OK;
+    }
+    for (i = 0; i < MF_JOB_EXIT_WAIT * 100; ++i)
+    {
+	if (pthread_mutex_trylock(&mf_job_mutex) == 0)
+	    return OK;
+	mch_delay(10L, TRUE);
+    }
+    return FAIL;
+}
+
+/*
+ * Wait for condition "cond" with "mf_job_mutex" locked.  When exiting for a
+ * deadly signal don't wait beyond "deadline".  Returns FAIL when timed out.
+ */
+    static int
+mf_job_wait(pthread_cond_t *cond, time_t deadline)
+{
+    struct timespec	ts;
+
+    if (!really_exiting)
+    {
+	pthread_cond_wait(cond, &mf_job_mutex);
+	return OK;
+    }
+    ts.tv_sec = deadline;
+    ts.tv_nsec = 0;
+    return pthread_cond_timedwait(cond, &mf_job_mutex, &ts) == ETIMEDOUT
+								? FAIL : OK;
+}
+
+/*
+ * Check the result of the queued writes for memfile "mfp", first wait for
+ * them to be done when "wait" is TRUE.  When a write failed give an error
+ * message and mark the blocks dirty, so that they are written again.
+ */
+    static void
+mf_job_check(memfile_T *mfp, int wait)
+{
+    mf_job_T	*done;
+    int		error;
+    bhdr_T	*hp;
+    time_t	deadline = time(NULL) + MF_JOB_EXIT_WAIT;
+
+    if (mf_writer_state <= 0 || mf_job_lock() == FAIL)
+	return;
+
+    while (wait && mfp->mf_jobs > 0)
+	if (mf_job_wait(&mf_job_done, deadline) == FAIL)
+	    break;
+    error = mfp->mf_job_error;
+    mfp->mf_job_error = FALSE;
+    done = mf_job_free;
+    mf_job_free = NULL;
+    pthread_mutex_unlock(&mf_job_mutex);
+
+    mf_job_free_list(done);
+    if (error)
+    {
+	if (!did_swapwrite_msg)
+	    EMSG(_("E297: Write error in swap file"));
+	did_swapwrite_msg = TRUE;
+	for (hp = mfp->mf_used_last; hp != NULL; hp = hp->bh_prev)
+	    if (hp->bh_bnum >= 0)
+		hp->bh_flags |= BH_DIRTY;
+	mfp->mf_dirty = TRUE;
+    }
+}
+
+/*
+ * Wait for the writer thread to be done with memfile "mfp".  Must be called
+ * before using or closing its file.
+ */
+    void
+mf_sync_wait(memfile_T *mfp)
+{
+    mf_job_check(mfp, TRUE);
+}
+
+/*
+ * The writer thread: does the queued jobs in order.  Only uses system
+ * functions, Vim's functions are not thread safe.
+ */
+    static void *
+mf_writer(void *arg UNUSED)
+{
+    mf_job_T	*job;
+    char_u	*p;
+    off_T	offset;
+    size_t	todo;
+    long	n;
+    int		ok;
+
+    pthread_mutex_lock(&mf_job_mutex);
+    for (;;)
+    {
+	while (mf_job_first == NULL)
+	    pthread_cond_wait(&mf_job_added, &mf_job_mutex);
+	job = mf_job_first;
+	mf_job_first = job->mj_next;
+	if (mf_job_first == NULL)
+	    mf_job_last = NULL;
+	pthread_mutex_unlock(&mf_job_mutex);
+
+	ok = TRUE;
+	if (job->mj_data != NULL)
+	{
+	    p = job->mj_data;
+	    offset = job->mj_offset;
+	    for (todo = job->mj_size; todo > 0; todo -= n)
+	    {
+		n = (long)pwrite(job->mj_fd, p, todo, offset);
+		if (n < 0 && errno == EINTR)
+		    n = 0;
+		else if (n <= 0)
+		{
+		    ok = FALSE;
+		    break;
+		}
+		p += n;
+		offset += n;
+	    }
+	}
+# ifdef HAVE_FSYNC
+	else if (job->mj_fd >= 0)
+	    (void)fsync(job->mj_fd);
+# endif
+	else
+	    sync();
+
+	pthread_mutex_lock(&mf_job_mutex);
+	if (!ok)
+	    job->mj_mfp->mf_job_error = TRUE;
+	--job->mj_mfp->mf_jobs;
+	mf_job_bytes -= job->mj_size;
+	job->mj_next = mf_job_free;
+	mf_job_free = job;
+	pthread_cond_broadcast(&mf_job_done);
+    }
+    /*NOTREACHED*/
+    return NULL;
+}
+#endif
+
 /*
  * Set mfp->mf_ffname according to mfp->mf_fname and some other things.
  * Only called when creating or renaming the swapfile.	Either way it's a new
@@ -255,6 +255,11 @@ static bhdr_T *ml_new_data(memfile_T *, int, int);
 static bhdr_T *ml_new_ptr(memfile_T *);
 static bhdr_T *ml_find_line(buf_T *, linenr_T, int);
 static int ml_add_stack(buf_T *);
+static bhdr_T *ml_cache_find(buf_T *buf, linenr_T lnum);
+static void ml_cache_add(buf_T *buf, bhdr_T *hp, linenr_T low, linenr_T high);
+#ifdef FEAT_LAZYREAD
+static void ml_fill_mapped_end(DATA_BL *dp, unsigned txt, int count);
+#endif
 static void ml_lineadd(buf_T *, int);
 static int b0_magic_wrong(ZERO_BL *);
 #ifdef CHECK_INODE
@@ -293,6 +298,7 @@ ml_open(buf_T *buf)
     buf->b_ml.ml_stack = NULL;	/* no stack yet */
     buf->b_ml.ml_stack_top = 0;	/* nothing in the stack */
     buf->b_ml.ml_locked = NULL;	/* no cached block */
+    buf->b_ml.ml_cache_len = 0;	/* no remembered data blocks */
     buf->b_ml.ml_line_lnum = 0;	/* no cached line */
 #ifdef FEAT_BYTEOFF
     buf->b_ml.ml_chunksize = NULL;
@@ -686,6 +692,9 @@ ml_setname(buf_T *buf)
 	/* need to close the swap file before renaming */
 	if (mfp->mf_fd >= 0)
 	{
+#ifdef FEAT_SWAP_THREAD
+	    mf_sync_wait(mfp);
+#endif
 	    close(mfp->mf_fd);
 	    mfp->mf_fd = -1;
 	}
@@ -1133,6 +1142,8 @@ ml_recover(void)
     long	mtime;
     int		attr;
     int		orig_file_status = NOTDONE;
+    linenr_T	orig_lines = 0;
+    linenr_T	old_lnum;
 
     recoverymode = TRUE;
     called_from_main = (curbuf->b_ml.ml_mfp == NULL);
@@ -1208,6 +1219,7 @@ ml_recover(void)
     buf->b_ml.ml_stack_top = 0;		/* nothing in the stack */
     buf->b_ml.ml_line_lnum = 0;		/* no cached line */
     buf->b_ml.ml_locked = NULL;		/* no locked block */
+    buf->b_ml.ml_cache_len = 0;		/* no remembered data blocks */
     buf->b_ml.ml_flags = 0;
 #ifdef FEAT_CRYPT
     buf->b_p_key = empty_option;
@@ -1436,6 +1448,19 @@ ml_recover(void)
     }
 #endif
 
+    /* When the original file was read with the same 'fileformat' and
+     * 'fileencoding' its lines can be used for data blocks with a negative
+     * number, see below. */
+    if (orig_file_status == OK
+	    && (b0_ff == 0 || get_fileformat(curbuf) == b0_ff - 1)
+#ifdef FEAT_MBYTE
+	    && (b0_fenc == NULL || STRCMP(curbuf->b_p_fenc, b0_fenc) == 0)
+#else
+	    && b0_fenc == NULL
+#endif
+	    )
+	orig_lines = curbuf->b_ml.ml_line_count - 1;
+
     /* Use the 'fileformat' and 'fileencoding' as stored in the swap file. */
     if (b0_ff != 0)
 	set_fileformat(b0_ff - 1, OPT_LOCAL);
@@ -1511,15 +1536,31 @@ ml_recover(void)
 		    {
 			/*
 			 * Data block with negative block number.
-			 * Try to read lines from the original file.
+			 * Copy the lines of the original file, they are below
+			 * the recovered lines: old line N is line "lnum + N".
+			 * Otherwise try reading them from the original file.
 			 * This is slow, but it works.
 			 */
-			if (!cannot_open)
+			line_count = pp->pb_pointer[idx].pe_line_count;
+			old_lnum = pp->pb_pointer[idx].pe_old_lnum;
+			if (old_lnum >= 1
+				&& old_lnum + line_count - 1 <= orig_lines)
+			{
+			    for (i = 0; i < line_count; ++i)
+			    {
+				/* Need to copy the line, appending may flush
+				 * it. */
+				p = vim_strsave(ml_get(lnum + old_lnum + i));
+				if (p == NULL)
+				    break;
+				ml_append(lnum++, p, (colnr_T)0, TRUE);
+				vim_free(p);
+			    }
+			}
+			else if (!cannot_open)
 			{
-			    line_count = pp->pb_pointer[idx].pe_line_count;
 			    if (readfile(curbuf->b_ffname, NULL, lnum,
-					pp->pb_pointer[idx].pe_old_lnum - 1,
-					line_count, NULL, 0) != OK)
+					old_lnum - 1, line_count, NULL, 0) != OK)
 				cannot_open = TRUE;
 			    else
 				lnum += line_count;
@@ -2292,7 +2333,8 @@ ml_sync_all(int check_file, int check_char)
 	}
 	if (buf->b_ml.ml_mfp->mf_dirty)
 	{
-	    (void)mf_sync(buf->b_ml.ml_mfp, (check_char ? MFS_STOP : 0)
+	    (void)mf_sync(buf->b_ml.ml_mfp,
+				    (check_char ? MFS_STOP | MFS_ASYNC : 0)
 					| (bufIsChanged(buf) ? MFS_FLUSH : 0));
 	    if (check_char && ui_char_avail())	/* character available now */
 		break;
@@ -2334,8 +2376,10 @@ ml_preserve(buf_T *buf, int message)
     (void)ml_find_line(buf, (linenr_T)0, ML_FLUSH); /* flush locked block */
     status = mf_sync(mfp, MFS_ALL | MFS_FLUSH);
 
-    /* stack is invalid after mf_sync(.., MFS_ALL) */
+    /* stack is invalid after mf_sync(.., MFS_ALL), the remembered data
+     * blocks must not skip the translations below */
     buf->b_ml.ml_stack_top = 0;
+    buf->b_ml.ml_cache_len = 0;
 
     /*
      * Some of the data blocks may have been changed from negative to
@@ -2603,6 +2647,7 @@ ml_append_int(
 
     mfp = buf->b_ml.ml_mfp;
     page_size = mfp->mf_page_size;
+    buf->b_ml.ml_cache_len = 0;	    /* remembered line numbers change */
 
 /*
  * find the data block containing the previous line
@@ -3148,6 +3193,8 @@ ml_delete_int(buf_T *buf, linenr_T lnum, int message)
     if (lowest_marked && lowest_marked > lnum)
 	lowest_marked--;
 
+    buf->b_ml.ml_cache_len = 0;	    /* remembered line numbers change */
+
 /*
  * If the file becomes empty the last line is replaced by an empty line.
  */
@@ -3621,6 +3668,11 @@ ml_find_line(buf_T *buf, linenr_T lnum, int action)
     if (action == ML_FLUSH)	    /* nothing else to do */
 	return NULL;
 
+    /* A recently used data block may avoid walking the tree. */
+    if (action == ML_FIND && !mf_dont_release
+				    && (hp = ml_cache_find(buf, lnum)) != NULL)
+	return hp;
+
     bnum = 1;			    /* start at the root of the tree */
     page_count = 1;
     low = 1;
@@ -3670,6 +3722,8 @@ ml_find_line(buf_T *buf, linenr_T lnum, int action)
 	    buf->b_ml.ml_locked_high = high;
 	    buf->b_ml.ml_locked_lineadd = 0;
 	    buf->b_ml.ml_flags &= ~(ML_LOCKED_DIRTY | ML_LOCKED_POS);
+	    if (action == ML_FIND)
+		ml_cache_add(buf, hp, low, high);
 	    return hp;
 	}
 
@@ -3757,6 +3811,108 @@ error_noblock:
     return NULL;
 }
 
+/*
+ * Look for a remembered data block that contains line "lnum".
+ * When found, lock it and restore the stack leading to it, like
+ * ml_find_line() would do.
+ * Returns NULL when not found.
+ */
+    static bhdr_T *
+ml_cache_find(buf_T *buf, linenr_T lnum)
+{
+    memfile_T	*mfp = buf->b_ml.ml_mfp;
+    mlcache_T	*mc = NULL;
+    bhdr_T	*hp;
+    DATA_BL	*dp;
+    int		i;
+    int		top;
+
+    for (i = 0; i < buf->b_ml.ml_cache_len; ++i)
+	if (buf->b_ml.ml_cache[i].mc_low <= lnum
+				       && buf->b_ml.ml_cache[i].mc_high >= lnum)
+	{
+	    mc = &buf->b_ml.ml_cache[i];
+	    break;
+	}
+    if (mc == NULL)
+	return NULL;
+
+    /* A negative block number may have been changed by mf_trans_add(), then
+     * the block can't be found and the entry is dropped. */
+    hp = mf_get(mfp, mc->mc_bnum, mc->mc_page_count);
+    if (hp != NULL)
+    {
+	dp = (DATA_BL *)(hp->bh_data);
+	if (dp->db_id != DATA_ID
+		|| (linenr_T)dp->db_line_count != mc->mc_high - mc->mc_low + 1)
+	{
+	    mf_put(mfp, hp, FALSE, FALSE);
+	    hp = NULL;
+	}
+    }
+
+    buf->b_ml.ml_stack_top = 0;
+    if (hp != NULL)
+	for (i = 0; i < mc->mc_depth; ++i)
+	{
+	    if ((top = ml_add_stack(buf)) < 0)
+	    {
+		mf_put(mfp, hp, FALSE, FALSE);
+		buf->b_ml.ml_stack_top = 0;
+		hp = NULL;
+		break;
+	    }
+	    buf->b_ml.ml_stack[top] = mc->mc_stack[i];
+	}
+    if (hp == NULL)
+    {
+	*mc = buf->b_ml.ml_cache[--buf->b_ml.ml_cache_len];
+	return NULL;
+    }
+
+    mc->mc_used = ++buf->b_ml.ml_cache_tick;
+    buf->b_ml.ml_locked = hp;
+    buf->b_ml.ml_locked_low = mc->mc_low;
+    buf->b_ml.ml_locked_high = mc->mc_high;
+    buf->b_ml.ml_locked_lineadd = 0;
+    buf->b_ml.ml_flags &= ~(ML_LOCKED_DIRTY | ML_LOCKED_POS);
+    return hp;
+}
+
+/*
+ * Remember data block "hp" with lines "low" to "high" and the current stack
+ * leading to it.  Replaces the least recently used entry when the cache is
+ * full.
+ */
+    static void
+ml_cache_add(buf_T *buf, bhdr_T *hp, linenr_T low, linenr_T high)
+{
+    mlcache_T	*mc;
+    int		i;
+
+    if (buf->b_ml.ml_stack_top > ML_CACHE_DEPTH)
+	return;
+
+    if (buf->b_ml.ml_cache_len < ML_CACHE_SIZE)
+	mc = &buf->b_ml.ml_cache[buf->b_ml.ml_cache_len++];
+    else
+    {
+	mc = &buf->b_ml.ml_cache[0];
+	for (i = 1; i < ML_CACHE_SIZE; ++i)
+	    if (buf->b_ml.ml_cache[i].mc_used < mc->mc_used)
+		mc = &buf->b_ml.ml_cache[i];
+    }
+
+    mc->mc_bnum = hp->bh_bnum;
+    mc->mc_page_count = hp->bh_page_count;
+    mc->mc_low = low;
+    mc->mc_high = high;
+    mc->mc_used = ++buf->b_ml.ml_cache_tick;
+    mc->mc_depth = buf->b_ml.ml_stack_top;
+    for (i = 0; i < mc->mc_depth; ++i)
+	mc->mc_stack[i] = buf->b_ml.ml_stack[i];
+}
+
 /*
  * add an entry to the info pointer stack
  *
@@ -4910,6 +5066,8 @@ ml_crypt_prepare(memfile_T *mfp, off_T offset, int reading)
 #define MLCS_MAXL 800	/* max no of lines in chunk */
 #define MLCS_MINL 400   /* should be half of MLCS_MAXL */
 
+static buf_T	*ml_upd_lastbuf = NULL;	/* buffer for cached chunk */
+
 /*
  * Keep information for finding byte offset of a line, updtype may be one of:
  * ML_CHNK_ADDLINE: Add len to parent chunk, possibly splitting it
@@ -4924,7 +5082,6 @@ ml_updatechunk(
     long	len,
     int		updtype)
 {
-    static buf_T	*ml_upd_lastbuf = NULL;
     static linenr_T	ml_upd_lastline;
     static linenr_T	ml_upd_lastcurline;
     static int		ml_upd_lastcurix;
@@ -5321,3 +5478,403 @@ goto_byte(long cnt)
 # endif
 }
 #endif
+
+#if defined(FEAT_LAZYREAD) || defined(PROTO)
+/*
+ * Append the lines of a mapped file to the empty current buffer without
+ * copying them, see 'lazyread'.  The text from "start" to "end" of the
+ * mapping "base" is split in data blocks with reserved negative numbers, the
+ * blocks are only made when they are needed (see ml_fill_mapped()).  Like
+ * other data blocks with a negative number, recovery gets the lines from the
+ * original file.
+ * "end" must be just after a NL.  When "dos" is TRUE every NL is preceded by
+ * a CR.
+ * On success the memfile owns the mapping and the number of lines is
+ * returned.  Returns zero for failure, the buffer is unchanged then.
+ */
+    linenr_T
+ml_append_mapped(
+    char_u	*base,	    /* start of the mapping */
+    off_T	len,	    /* length of the mapping */
+    stat_T	*st,	    /* info about the mapped file */
+    off_T	start,	    /* offset of the first line */
+    off_T	end,	    /* offset just after the last line */
+    int		dos)	    /* lines end in CR-NL */
+{
+    int		ok = FALSE;
+    buf_T	*buf = curbuf;
+    memfile_T	*mfp = buf->b_ml.ml_mfp;
+    unsigned	page_size;
+    lazyfile_T	*mm = NULL;
+    garray_T	blocks;		/* lazyblock_T for each block */
+    garray_T	entries;	/* PTR_EN for each block, later for
+				   each pointer block */
+    PTR_EN	*pe;
+    lazyblock_T	*mb;
+    bhdr_T	*hp;
+    PTR_BL	*pp;
+    int		pb_count_max;
+    blocknr_T	*ptrs = NULL;	/* pointer blocks made so far */
+    int		ptrs_len = 0;
+    int		ptrs_max = 0;
+    blocknr_T	*np;
+    blocknr_T	first;
+    linenr_T	lines = 0;
+    long	used;
+    long	l;
+    int		count;
+    int		i;
+    int		j;
+    char_u	*p;
+    char_u	*e = base + end;
+    char_u	*nl;
+#ifdef FEAT_BYTEOFF
+    garray_T	chunks;		/* chunksize_T for line2byte() */
+    chunksize_T	*cs = NULL;
+#endif
+
+    if (mfp == NULL || mfp->mf_mapped != NULL
+	    || !(buf->b_ml.ml_flags & ML_EMPTY)
+	    || buf->b_ml.ml_line_count != 1)
+	return 0;
+    page_size = mfp->mf_page_size;
+    pb_count_max = (int)((page_size - sizeof(PTR_BL)) / sizeof(PTR_EN) + 1);
+    first = mfp->mf_blocknr_min;
+
+    ga_init2(&blocks, (int)sizeof(lazyblock_T), 1000);
+    ga_init2(&entries, (int)sizeof(PTR_EN), 1000);
+#ifdef FEAT_BYTEOFF
+    ga_init2(&chunks, (int)sizeof(chunksize_T), 100);
+#endif
+
+    /*
+     * Split the text in blocks of one page.  A line that doesn't fit in a
+     * page gets a block of its own, like ml_append_int() does.
+     */
+    for (p = base + start; p < e; )
+    {
+	/* There can be millions of blocks, grow by the current size. */
+	blocks.ga_growsize = blocks.ga_len + 1000;
+	entries.ga_growsize = entries.ga_len + 1000;
+	if (ga_grow(&blocks, 1) == FAIL || ga_grow(&entries, 1) == FAIL)
+	    goto theend;
+	mb = (lazyblock_T *)blocks.ga_data + blocks.ga_len;
+	pe = (PTR_EN *)entries.ga_data + entries.ga_len;
+	mb->mb_offset = (off_T)(p - base);
+	mb->mb_mapped = TRUE;
+	pe->pe_bnum = first - blocks.ga_len;
+	pe->pe_old_lnum = lines + 1;
+	pe->pe_line_count = 0;
+
+	used = HEADER_SIZE;
+	while (p < e)
+	{
+	    nl = (char_u *)memchr(p, NL, (size_t)(e - p));
+	    l = (long)(nl - p) - dos + 1 + INDEX_SIZE;
+	    if (pe->pe_line_count > 0 && used + l > (long)page_size)
+		break;
+	    if (l > MAXCOL / 2)		/* line is too long */
+		goto theend;
+	    used += l;
+	    ++pe->pe_line_count;
+	    ++lines;
+	    p = nl + 1;
+#ifdef FEAT_BYTEOFF
+	    if (cs == NULL || cs->mlcs_numlines >= MLCS_MINL)
+	    {
+		chunks.ga_growsize = chunks.ga_len + 100;
+		if (ga_grow(&chunks, 1) == FAIL)
+		    goto theend;
+		cs = (chunksize_T *)chunks.ga_data + chunks.ga_len++;
+		cs->mlcs_numlines = 0;
+		cs->mlcs_totalsize = 0;
+	    }
+	    ++cs->mlcs_numlines;
+	    cs->mlcs_totalsize += l - INDEX_SIZE;
+#endif
+	}
+	mb->mb_len = (int)((p - base) - mb->mb_offset);
+	mb->mb_line_count = (int)pe->pe_line_count;
+	pe->pe_page_count = (int)((used + page_size - 1) / page_size);
+	++blocks.ga_len;
+	++entries.ga_len;
+    }
+    if (blocks.ga_len == 0
+	    || (mm = (lazyfile_T *)alloc_clear((unsigned)sizeof(lazyfile_T)))
+								      == NULL)
+	goto theend;
+
+    ml_flush_line(buf);				    /* flush buffered line */
+    (void)ml_find_line(buf, (linenr_T)0, ML_FLUSH); /* flush locked block */
+    buf->b_ml.ml_stack_top = 0;		    /* stack is invalid now */
+    buf->b_ml.ml_cache_len = 0;
+
+    /* The new lines go before the entries of the root block. */
+    if ((hp = mf_get(mfp, (blocknr_T)1, 1)) == NULL)
+	goto theend;
+    pp = (PTR_BL *)(hp->bh_data);
+    if (ga_grow(&entries, pp->pb_count) == FAIL)
+    {
+	mf_put(mfp, hp, FALSE, FALSE);
+	goto theend;
+    }
+    mch_memmove((PTR_EN *)entries.ga_data + entries.ga_len, pp->pb_pointer,
+					   pp->pb_count * sizeof(PTR_EN));
+    entries.ga_len += pp->pb_count;
+    mf_put(mfp, hp, FALSE, FALSE);
+
+    /*
+     * Build the tree from the bottom up: when there are too many entries for
+     * the root block put them in pointer blocks, the entries for those
+     * blocks replace them.
+     */
+    pe = (PTR_EN *)entries.ga_data;
+    count = entries.ga_len;
+    while (count > pb_count_max)
+    {
+	for (i = 0, j = 0; i < count; i += pb_count_max, ++j)
+	{
+	    /* Remember the pointer blocks, to free them when failing. */
+	    if (ptrs_len == ptrs_max)
+	    {
+		ptrs_max = ptrs_max == 0 ? 8 : ptrs_max * 2;
+		np = (blocknr_T *)lalloc_id(
+				(long_u)(ptrs_max * sizeof(blocknr_T)), TRUE,
+								aid_lazy_ptrs);
+		if (np == NULL)
+		    goto theend;
+		if (ptrs_len > 0)
+		    mch_memmove(np, ptrs, ptrs_len * sizeof(blocknr_T));
+		vim_free(ptrs);
+		ptrs = np;
+	    }
+	    if ((hp = ml_new_ptr(mfp)) == NULL)
+		goto theend;
+	    ptrs[ptrs_len++] = hp->bh_bnum;
+	    pp = (PTR_BL *)(hp->bh_data);
+	    pp->pb_count = (short_u)(count - i < pb_count_max
+						? count - i : pb_count_max);
+	    mch_memmove(pp->pb_pointer, pe + i,
+					   pp->pb_count * sizeof(PTR_EN));
+	    pe[j].pe_bnum = hp->bh_bnum;
+	    pe[j].pe_old_lnum = pp->pb_pointer[0].pe_old_lnum;
+	    pe[j].pe_page_count = 1;
+	    pe[j].pe_line_count = 0;
+	    for (l = 0; l < pp->pb_count; ++l)
+		pe[j].pe_line_count += pp->pb_pointer[l].pe_line_count;
+	    mf_put(mfp, hp, TRUE, FALSE);
+	}
+	count = j;
+    }
+    if ((hp = mf_get(mfp, (blocknr_T)1, 1)) == NULL)
+	goto theend;
+    pp = (PTR_BL *)(hp->bh_data);
+    pp->pb_count = count;
+    mch_memmove(pp->pb_pointer, pe, count * sizeof(PTR_EN));
+    mf_put(mfp, hp, TRUE, FALSE);
+
+    /* The memfile now owns the mapping. */
+    mm->mm_base = base;
+    mm->mm_len = len;
+    mm->mm_dev = st->st_dev;
+    mm->mm_ino = st->st_ino;
+    mm->mm_dos = dos;
+    mm->mm_first = first;
+    mm->mm_count = blocks.ga_len;
+    mm->mm_blocks = (lazyblock_T *)blocks.ga_data;
+    ga_init(&blocks);
+    mfp->mf_mapped = mm;
+    mfp->mf_blocknr_min = first - mm->mm_count;
+    mm = NULL;
+    ok = TRUE;
+
+    buf->b_ml.ml_line_count += lines;
+    buf->b_ml.ml_flags &= ~ML_EMPTY;
+
+#ifdef FEAT_BYTEOFF
+    /* The chunks for the existing line go after the new ones. */
+    if (buf->b_ml.ml_usedchunks != -1)
+    {
+	i = buf->b_ml.ml_chunksize == NULL ? 1 : buf->b_ml.ml_usedchunks;
+	chunks.ga_growsize = i + 100;
+	if (ga_grow(&chunks, i + 100) == FAIL)
+	{
+	    vim_free(buf->b_ml.ml_chunksize);
+	    buf->b_ml.ml_chunksize = NULL;
+	    buf->b_ml.ml_usedchunks = -1;
+	}
+	else
+	{
+	    cs = (chunksize_T *)chunks.ga_data + chunks.ga_len;
+	    if (buf->b_ml.ml_chunksize == NULL)
+	    {
+		cs->mlcs_numlines = 1;
+		cs->mlcs_totalsize = 1;
+	    }
+	    else
+		mch_memmove(cs, buf->b_ml.ml_chunksize,
+						      i * sizeof(chunksize_T));
+	    vim_free(buf->b_ml.ml_chunksize);
+	    buf->b_ml.ml_chunksize = (chunksize_T *)chunks.ga_data;
+	    buf->b_ml.ml_usedchunks = chunks.ga_len + i;
+	    buf->b_ml.ml_numchunks = chunks.ga_maxlen;
+	    ga_init(&chunks);
+	}
+	ml_upd_lastbuf = NULL;	    /* force recalc of curix & curline */
+    }
+#endif
+
+theend:
+    if (!ok)
+	/* Free the pointer blocks, nothing refers to them. */
+	for (i = 0; i < ptrs_len; ++i)
+	    if ((hp = mf_get(mfp, ptrs[i], 1)) != NULL)
+		mf_free(mfp, hp);
+    vim_free(ptrs);
+    vim_free(mm);
+    ga_clear(&blocks);
+    ga_clear(&entries);
+#ifdef FEAT_BYTEOFF
+    ga_clear(&chunks);
+#endif
+    return ok ? lines : 0;
+}
+
+/*
+ * Make data block "hp" of a lazily read file from the mapped text.
+ * When another program truncated the file the text past the new end can't be
+ * used, accessing it gives SIGBUS.  The lines are made empty then and FAIL is
+ * returned.
+ */
+    int
+ml_fill_mapped(memfile_T *mfp, bhdr_T *hp)
+{
+    lazyfile_T	*mm = mfp->mf_mapped;
+    lazyblock_T	*mb = &mm->mm_blocks[mm->mm_first - hp->bh_bnum];
+    DATA_BL	*dp = (DATA_BL *)(hp->bh_data);
+    /* volatile: changed after SETJMP() */
+    char_u	*volatile p = mm->mm_base + mb->mb_offset;
+    char_u	*e = p + mb->mb_len;
+    char_u	*nl;
+    char_u	*s;
+    char_u	*n;
+    unsigned	txt = mfp->mf_page_size * hp->bh_page_count;
+    long	len;
+    int		idx = 0;
+    int		protect = !lc_active;	/* can't nest mch_startjmp() */
+
+    dp->db_id = DATA_ID;
+    dp->db_txt_end = txt;
+    if (protect)
+    {
+	mch_startjmp();
+	if (SETJMP(lc_jump_env) != 0)
+	{
+	    mch_didjmp();
+	    if (!mm->mm_truncated)
+	    {
+		mm->mm_truncated = TRUE;
+		EMSG(_("E949: File was truncated while being read lazily, lines are empty"));
+	    }
+	    txt = dp->db_txt_end;
+	    for (idx = 0; idx < mb->mb_line_count; ++idx)
+	    {
+		--txt;
+		*((char_u *)dp + txt) = NUL;
+		dp->db_index[idx] = txt;
+	    }
+	    ml_fill_mapped_end(dp, txt, idx);
+	    return FAIL;
+	}
+    }
+    while (p < e)
+    {
+	nl = (char_u *)memchr(p, NL, (size_t)(e - p));
+	len = (long)(nl - p) - mm->mm_dos;
+	txt -= len + 1;
+	s = (char_u *)dp + txt;
+	mch_memmove(s, p, (size_t)len);
+	s[len] = NUL;
+	/* A NUL in the file is a NL in the buffer, like readfile() does. */
+	n = s;
+	while ((n = (char_u *)memchr(n, NUL, (size_t)(s + len - n))) != NULL)
+	    *n++ = NL;
+	dp->db_index[idx++] = txt;
+	p = nl + 1;
+    }
+    if (protect)
+	mch_endjmp();
+    ml_fill_mapped_end(dp, txt, idx);
+    return OK;
+}
+
+/*
+ * Finish data block "dp" made from the mapped text, with "count" lines, the
+ * text starting at "txt".
+ */
+    static void
+ml_fill_mapped_end(DATA_BL *dp, unsigned txt, int count)
+{
+    char_u	*s;
+
+    dp->db_txt_start = txt;
+    dp->db_line_count = count;
+    dp->db_free = txt - (unsigned)(HEADER_SIZE + count * INDEX_SIZE);
+
+    /* Avoid that memory garbage ends up in the swap file. */
+    s = (char_u *)(dp->db_index + count);
+    vim_memset(s, 0, (size_t)(((char_u *)dp + txt) - s));
+}
+
+/*
+ * Copy the text of all blocks of "buf" that are still made from the mapped
+ * file and remove the mapping.  Must be done before the file is changed.
+ */
+    void
+ml_unmap(buf_T *buf)
+{
+    memfile_T	*mfp = buf->b_ml.ml_mfp;
+    linenr_T	lnum;
+    bhdr_T	*hp;
+
+    if (mfp == NULL || mfp->mf_mapped == NULL)
+	return;
+
+    ml_flush_line(buf);
+    for (lnum = 1; lnum <= buf->b_ml.ml_line_count;
+					   lnum = buf->b_ml.ml_locked_high + 1)
+    {
+	if ((hp = ml_find_line(buf, lnum, ML_FIND)) == NULL)
+	    return;	    /* keep the mapping */
+	/* The block is claimed when it's released below. */
+	if (hp->bh_bnum < 0)
+	    buf->b_ml.ml_flags |= ML_LOCKED_DIRTY;
+    }
+    (void)ml_find_line(buf, (linenr_T)0, ML_FLUSH);
+    mf_unmap(mfp);
+}
+
+/*
+ * The file "fname" is going to be overwritten: remove the mapping of a buffer
+ * that reads it lazily.
+ */
+    void
+ml_unmap_file(char_u *fname)
+{
+    buf_T	*buf;
+    stat_T	st;
+    lazyfile_T	*mm;
+
+    /* Most of the time no file is mapped, avoid the stat() then. */
+    FOR_ALL_BUFFERS(buf)
+	if (buf->b_ml.ml_mfp != NULL && buf->b_ml.ml_mfp->mf_mapped != NULL)
+	    break;
+    if (buf == NULL || mch_stat((char *)fname, &st) < 0)
+	return;
+    FOR_ALL_BUFFERS(buf)
+	if (buf->b_ml.ml_mfp != NULL
+		&& (mm = buf->b_ml.ml_mfp->mf_mapped) != NULL
+		&& mm->mm_dev == st.st_dev && mm->mm_ino == st.st_ino)
+	    ml_unmap(buf);
+}
+#endif
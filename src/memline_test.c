@@ -0,0 +1,175 @@
+/* vi:set ts=8 sts=4 sw=4 noet:
+ *
+ * VIM - Vi IMproved	by Bram Moolenaar
+ *
+ * Do ":help uganda"  in Vim to read copying and usage conditions.
+ * Do ":help credits" in Vim to see a list of people who contributed.
+ * See README.txt for an overview of the Vim source code.
+ */
+
+/*
+ * memline_test.c: Unittests for memline.c
+ *
+ * Run "memline_test bench" to compare the time for finding lines in
+ * different data blocks with and without the cache of recently used blocks.
+ */
+
+#undef NDEBUG
+#include <assert.h>
+
+/* Must include main.c because it contains much more than just main() */
+#define NO_VIM_MAIN
+#include "main.c"
+
+#define LINE_COUNT  300000L
+#define TARGET_COUNT 8
+
+/* original number of each line, index 0 is line 1 */
+static long	*model;
+static long	model_count;
+
+/*
+ * Make the text for the line with original number "nr" in "buf".
+ */
+    static char_u *
+make_line(char_u *buf, long nr)
+{
+    int		i;
+    int		len;
+
+    len = sprintf((char *)buf, "line %ld ", nr);
+    for (i = 0; i < nr % 50; ++i)
+	buf[len++] = 'x';
+    buf[len] = NUL;
+    return buf;
+}
+
+    static void
+check_line(linenr_T lnum)
+{
+    char_u	buf[100];
+
+    assert(STRCMP(ml_get(lnum), make_line(buf, model[lnum - 1])) == 0);
+}
+
+/*
+ * Fill the current buffer with LINE_COUNT lines.
+ */
+    static void
+fill_buffer(void)
+{
+    char_u	buf[100];
+    long	nr;
+
+    model = (long *)alloc((unsigned)((LINE_COUNT + 1000) * sizeof(long)));
+    assert(model != NULL);
+    for (nr = 1; nr <= LINE_COUNT; ++nr)
+    {
+	assert(ml_append(nr - 1, make_line(buf, nr), (colnr_T)0, FALSE) == OK);
+	model[nr - 1] = nr;
+    }
+    /* remove the empty line that a new buffer starts with */
+    assert(ml_delete(LINE_COUNT + 1, FALSE) == OK);
+    model_count = LINE_COUNT;
+    assert(curbuf->b_ml.ml_line_count == LINE_COUNT);
+}
+
+/*
+ * Get lines far apart in turn, while lines are added and deleted near them,
+ * which moves the lines in the cached blocks and splits blocks.
+ */
+    static void
+test_ml_get_cache(void)
+{
+    linenr_T	targets[TARGET_COUNT];
+    char_u	buf[100];
+    long	round;
+    int		i;
+    linenr_T	lnum;
+
+    for (i = 0; i < TARGET_COUNT; ++i)
+	targets[i] = (linenr_T)(1 + i * (LINE_COUNT / TARGET_COUNT));
+
+    for (round = 0; round < 500; ++round)
+    {
+	for (i = 0; i < TARGET_COUNT; ++i)
+	{
+	    check_line(targets[i]);
+	    check_line(targets[TARGET_COUNT - 1 - i]);
+	}
+
+	i = (int)(round % TARGET_COUNT);
+	lnum = targets[i] + (linenr_T)(round % 7);
+	if (round % 3 == 0)
+	{
+	    /* delete a line */
+	    assert(ml_delete(lnum, FALSE) == OK);
+	    mch_memmove(model + lnum - 1, model + lnum,
+			      (size_t)(model_count - lnum) * sizeof(long));
+	    --model_count;
+	}
+	else
+	{
+	    /* add a line after "lnum" */
+	    assert(ml_append(lnum, make_line(buf, LINE_COUNT + round),
+						    (colnr_T)0, FALSE) == OK);
+	    mch_memmove(model + lnum + 1, model + lnum,
+			      (size_t)(model_count - lnum) * sizeof(long));
+	    model[lnum] = LINE_COUNT + round;
+	    ++model_count;
+	}
+	assert(curbuf->b_ml.ml_line_count == model_count);
+	check_line(lnum);
+    }
+
+    for (lnum = 1; lnum <= model_count; ++lnum)
+	check_line(lnum);
+}
+
+/*
+ * Time getting lines in different blocks in turn.  When "use_cache" is FALSE
+ * the cache is cleared before each lookup, so that the tree is walked.
+ */
+    static long
+bench_ml_get(int use_cache)
+{
+    static linenr_T targets[TARGET_COUNT] =
+		  {1, 37000, 75000, 110000, 150000, 190000, 230000, 299000};
+    struct timeval  start, end;
+    long	    count;
+    long	    sum = 0;
+    int		    i;
+
+    gettimeofday(&start, NULL);
+    for (count = 0; count < 1000000L; ++count)
+	for (i = 0; i < TARGET_COUNT; ++i)
+	{
+	    if (!use_cache)
+		curbuf->b_ml.ml_cache_len = 0;
+	    sum += *ml_get(targets[i]);
+	}
+    gettimeofday(&end, NULL);
+    assert(sum == 1000000L * TARGET_COUNT * 'l');
+    return (long)(end.tv_sec - start.tv_sec) * 1000L
+				     + (long)(end.tv_usec - start.tv_usec) / 1000L;
+}
+
+    int
+main(int argc, char **argv)
+{
+    vim_memset(&params, 0, sizeof(params));
+    params.argc = argc;
+    params.argv = argv;
+    common_init(&params);
+    assert(ml_open(curbuf) == OK);
+
+    fill_buffer();
+    if (argc > 1 && strcmp(argv[1], "bench") == 0)
+    {
+	printf("without cache: %ld msec\n", bench_ml_get(FALSE));
+	printf("with cache:    %ld msec\n", bench_ml_get(TRUE));
+    }
+    else
+	test_ml_get_cache();
+    return 0;
+}
@@ -622,6 +622,9 @@ EXTERN long	p_stal;		/* 'showtabline' */
 EXTERN char_u	*p_lcs;		/* 'listchars' */
 
 EXTERN int	p_lz;		/* 'lazyredraw' */
+#ifdef FEAT_LAZYREAD
+EXTERN long	p_lzr;		/* 'lazyread' */
+#endif
 EXTERN int	p_lpl;		/* 'loadplugins' */
 #if defined(DYNAMIC_LUA)
 EXTERN char_u	*p_luadll;	/* 'luadll' */
@@ -54,6 +54,13 @@ static int selinux_enabled = -1;
 # endif
 #endif
 
+#ifdef HAVE_COPY_FILE_RANGE
+# include <sys/syscall.h>
+#endif
+#ifdef HAVE_FICLONE
+# include <linux/fs.h>
+#endif
+
 /*
  * Use this prototype for select, some include files have a wrong prototype
  */
@@ -963,7 +970,7 @@ sig_alarm SIGDEFARG(sigarg)
 
 #if (defined(HAVE_SETJMP_H) \
 	&& ((defined(FEAT_X11) && defined(FEAT_XCLIPBOARD)) \
-	    || defined(FEAT_LIBCALL))) \
+	    || defined(FEAT_LIBCALL) || defined(FEAT_LAZYREAD))) \
     || defined(PROTO)
 /*
  * A simplistic version of setjmp() that only allows one level of using.
@@ -2752,6 +2759,88 @@ mch_setperm(char_u *name, long perm)
 		    (mode_t)perm) == 0 ? OK : FAIL);
 }
 
+#if defined(FEAT_LAZYREAD) || defined(PROTO)
+/*
+ * Version of open() that removes the mapping of a file that is read lazily
+ * before it is overwritten.
+ */
+    int
+mch_open(const char *name, int flags, int mode)
+{
+    if ((flags & (O_WRONLY | O_RDWR)) != 0 && (flags & O_APPEND) == 0)
+	ml_unmap_file((char_u *)name);
+    return open(name, flags, mode);
+}
+
+/*
+ * Version of fopen() that removes the mapping of a file that is read lazily
+ * before it is overwritten.
+ */
+    FILE *
+mch_fopen(const char *name, const char *mode)
+{
+    if (*mode == 'w' || (*mode == 'r' && vim_strchr((char_u *)mode, '+')))
+	ml_unmap_file((char_u *)name);
+    return fopen(name, mode);
+}
+#endif
+
+/*
+ * Copy up to "size" bytes from file descriptor "from_fd" to "to_fd" without
+ * reading them: make a reflink that shares the blocks, or let the kernel
+ * copy them.  Both files must be at the start, the file positions are moved
+ * past the copied data.
+ * Returns the number of bytes copied, the caller has to copy the rest.
+ */
+    off_T
+mch_copy_file_data(int from_fd, int to_fd, off_T size)
+{
+    off_T	done = 0;
+#ifdef HAVE_COPY_FILE_RANGE
+    long	n;
+    long	chunk = 0x1000000L;
+
+# ifdef FEAT_EVAL
+    if (copy_chunk_for_testing > 0)
+	chunk = copy_chunk_for_testing;
+# endif
+#endif
+
+#ifdef HAVE_FICLONE
+    if (
+# ifdef FEAT_EVAL
+	    copy_chunk_for_testing == 0 &&
+# endif
+	    ioctl(to_fd, FICLONE, from_fd) == 0)
+    {
+	/* the whole file was cloned */
+	done = lseek(from_fd, (off_T)0, SEEK_END);
+	if (done > 0 && lseek(to_fd, done, SEEK_SET) == done)
+	    return done;
+	(void)lseek(from_fd, (off_T)0, SEEK_SET);
+	if (ftruncate(to_fd, (off_T)0) != 0)
+	    return 0;
+	done = 0;
+    }
+#endif
+#ifdef HAVE_COPY_FILE_RANGE
+    /* Some file systems report a wrong size of zero, stop at "size" and let
+     * the caller read what remains. */
+    while (done < size && !got_int)
+    {
+	n = syscall(SYS_copy_file_range, from_fd, NULL, to_fd, NULL,
+					(size_t)MIN(size - done, chunk), 0);
+	if (n < 0 && errno == EINTR)
+	    continue;
+	if (n <= 0)
+	    break;
+	done += n;
+	ui_breakcheck();
+    }
+#endif
+    return done;
+}
+
 #if defined(HAVE_ACL) || defined(PROTO)
 # ifdef HAVE_SYS_ACL_H
 #  include <sys/acl.h>
@@ -135,6 +135,10 @@
 # include <sys/time.h>
 #endif
 
+#ifdef HAVE_SYS_MMAN_H
+# include <sys/mman.h>	    /* for mmap() */
+#endif
+
 #include <signal.h>
 
 #if defined(DIRSIZ) && !defined(MAXNAMLEN)
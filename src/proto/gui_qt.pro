@@ -85,4 +85,6 @@ void gui_mch_drawsign (int row, int col, int typenr);
 void gui_mch_update_fuoptions (char_u *optstr);
 void * qt_socket_notifier_read(int fd, void (fptr)(int));
 void * qt_socket_notifier_ex(int fd, void (fptr)(int));
+void gui_mch_profile(dict_T *d, char_u *fname);
+void qt_interrupt_wait(void);
 void qt_remove_socket_notifier(void *inp);
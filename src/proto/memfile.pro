@@ -12,6 +12,8 @@ int mf_sync(memfile_T *mfp, int flags);
 void mf_set_dirty(memfile_T *mfp);
 int mf_release_all(void);
 blocknr_T mf_trans_del(memfile_T *mfp, blocknr_T old_nr);
+void mf_unmap(memfile_T *mfp);
+void mf_sync_wait(memfile_T *mfp);
 void mf_set_ffname(memfile_T *mfp);
 void mf_fullname(memfile_T *mfp);
 int mf_need_trans(memfile_T *mfp);
@@ -34,4 +34,8 @@ char_u *ml_encrypt_data(memfile_T *mfp, char_u *data, off_T offset, unsigned siz
 void ml_decrypt_data(memfile_T *mfp, char_u *data, off_T offset, unsigned size);
 long ml_find_line_or_offset(buf_T *buf, linenr_T lnum, long *offp);
 void goto_byte(long cnt);
+linenr_T ml_append_mapped(char_u *base, off_T len, stat_T *st, off_T start, off_T end, int dos);
+int ml_fill_mapped(memfile_T *mfp, bhdr_T *hp);
+void ml_unmap(buf_T *buf);
+void ml_unmap_file(char_u *fname);
 /* vim: set ft=c : */
@@ -3,18 +3,15 @@
 
 #include <QColor>
 #include <QString>
-#include <QHash>
 
-class ColorTable: public QHash<QString, QColor>
+/**
+ * Vim color names, generated from rgb.txt by gencolortable.py
+ */
+class ColorTable
 {
 public:
+	static bool lookup(const char *name, QRgb *rgb);
 	static QColor get(const QString& name, const QColor &fallback=QColor());
-
-protected:
-	ColorTable();
-
-private:
-	static ColorTable m_instance;
 };
 
 #endif
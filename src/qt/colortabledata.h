@@ -0,0 +1,707 @@
+/*
+ * DONT EDIT - auto generated from rgb.txt by qt/gencolortable.py
+ */
+static const int colorTableSize = 678;
+static const int colorSeedCount = 170;
+
+static const unsigned short colorSeeds[] = {
+	8, 16, 1, 6, 72, 6, 55, 33, 23, 1, 91, 7,
+	1, 21, 567, 112, 15, 14, 6, 15, 3, 6, 1, 8,
+	1, 3, 4, 346, 131, 10, 2, 10, 9, 2, 20, 67,
+	42, 2, 37, 67, 88, 4, 62, 1, 80, 19, 107, 52,
+	121, 95, 92, 12, 5, 11, 24, 144, 16, 72, 78, 23,
+	147, 199, 167, 6, 8, 4, 44, 4, 3, 0, 268, 256,
+	1, 32, 89, 105, 4, 221, 8, 124, 148, 318, 1, 296,
+	39, 68, 48, 15, 2, 1, 175, 477, 14, 61, 169, 63,
+	3, 315, 1, 17, 431, 850, 38, 22, 93, 18, 88, 2,
+	789, 27, 10, 236, 3, 9, 7, 469, 1016, 6, 152, 3,
+	536, 581, 145, 724, 20, 1, 3969, 29, 4, 425, 8, 3,
+	30, 773, 1140, 1768, 1, 258, 76, 427, 63, 5425, 1228, 0,
+	16358, 10, 2, 85, 6, 16, 71, 3, 11, 152, 25, 236,
+	147, 29, 23, 1258, 707, 8, 3624, 0, 1152, 55, 18897, 142,
+	12, 1,
+};
+
+static const struct {
+	const char *name;
+	QRgb rgb;
+} colorEntries[] = {
+	{"gray87", 0xFFDEDEDE},
+	{"gray19", 0xFF303030},
+	{"cyan", 0xFF00FFFF},
+	{"seagreen4", 0xFF2E8B57},
+	{"oldlace", 0xFFFDF5E6},
+	{"green", 0xFF00FF00},
+	{"ivory3", 0xFFCDCDC1},
+	{"grey54", 0xFF8A8A8A},
+	{"cornflowerblue", 0xFF6495ED},
+	{"tan4", 0xFF8B5A2B},
+	{"grey72", 0xFFB8B8B8},
+	{"gray89", 0xFFE3E3E3},
+	{"grey78", 0xFFC7C7C7},
+	{"crimson", 0xFFDC143C},
+	{"grey56", 0xFF8F8F8F},
+	{"grey34", 0xFF575757},
+	{"gray12", 0xFF1F1F1F},
+	{"x11maroon", 0xFFB03060},
+	{"olivedrab4", 0xFF698B22},
+	{"gray25", 0xFF404040},
+	{"turquoise1", 0xFF00F5FF},
+	{"cadetblue3", 0xFF7AC5CD},
+	{"maroon", 0xFFB03060},
+	{"darkviolet", 0xFF9400D3},
+	{"indianred2", 0xFFEE6363},
+	{"cyan1", 0xFF00FFFF},
+	{"gray57", 0xFF919191},
+	{"steelblue4", 0xFF36648B},
+	{"slateblue2", 0xFF7A67EE},
+	{"indianred4", 0xFF8B3A3A},
+	{"gray76", 0xFFC2C2C2},
+	{"springgreen4", 0xFF008B45},
+	{"gray17", 0xFF2B2B2B},
+	{"violetred2", 0xFFEE3A8C},
+	{"deepskyblue4", 0xFF00688B},
+	{"sienna1", 0xFFFF8247},
+	{"sandybrown", 0xFFF4A460},
+	{"grey80", 0xFFCCCCCC},
+	{"gray14", 0xFF242424},
+	{"sienna4", 0xFF8B4726},
+	{"sienna2", 0xFFEE7942},
+	{"darkkhaki", 0xFFBDB76B},
+	{"gray90", 0xFFE5E5E5},
+	{"burlywood4", 0xFF8B7355},
+	{"lightyellow2", 0xFFEEEED1},
+	{"bisque4", 0xFF8B7D6B},
+	{"goldenrod4", 0xFF8B6914},
+	{"orange3", 0xFFCD8500},
+	{"steelblue3", 0xFF4F94CD},
+	{"chocolate4", 0xFF8B4513},
+	{"wheat3", 0xFFCDBA96},
+	{"lightsteelblue3", 0xFFA2B5CD},
+	{"paleturquoise3", 0xFF96CDCD},
+	{"grey53", 0xFF878787},
+	{"mediumpurple4", 0xFF5D478B},
+	{"gold", 0xFFFFD700},
+	{"springgreen3", 0xFF00CD66},
+	{"mediumpurple3", 0xFF8968CD},
+	{"grey24", 0xFF3D3D3D},
+	{"hotpink", 0xFFFF69B4},
+	{"navajowhite1", 0xFFFFDEAD},
+	{"grey7", 0xFF121212},
+	{"gray31", 0xFF4F4F4F},
+	{"grey94", 0xFFF0F0F0},
+	{"whitesmoke", 0xFFF5F5F5},
+	{"grey8", 0xFF141414},
+	{"orangered3", 0xFFCD3700},
+	{"snow4", 0xFF8B8989},
+	{"deepskyblue1", 0xFF00BFFF},
+	{"grey2", 0xFF050505},
+	{"gray11", 0xFF1C1C1C},
+	{"grey14", 0xFF242424},
+	{"gray35", 0xFF595959},
+	{"antiquewhite2", 0xFFEEDFCC},
+	{"gray", 0xFFBEBEBE},
+	{"firebrick3", 0xFFCD2626},
+	{"darkslategrey", 0xFF2F4F4F},
+	{"darkorchid", 0xFF9932CC},
+	{"grey99", 0xFFFCFCFC},
+	{"mediumpurple", 0xFF9370DB},
+	{"gray15", 0xFF262626},
+	{"seashell4", 0xFF8B8682},
+	{"royalblue2", 0xFF436EEE},
+	{"lightsteelblue2", 0xFFBCD2EE},
+	{"plum", 0xFFDDA0DD},
+	{"gray18", 0xFF2E2E2E},
+	{"blue", 0xFF0000FF},
+	{"gray46", 0xFF757575},
+	{"grey6", 0xFF0F0F0F},
+	{"gray39", 0xFF636363},
+	{"seagreen", 0xFF2E8B57},
+	{"hotpink4", 0xFF8B3A62},
+	{"olivedrab", 0xFF6B8E23},
+	{"brown", 0xFFA52A2A},
+	{"paleturquoise", 0xFFAFEEEE},
+	{"lightsalmon2", 0xFFEE9572},
+	{"antiquewhite4", 0xFF8B8378},
+	{"deepskyblue2", 0xFF00B2EE},
+	{"grey16", 0xFF292929},
+	{"dodgerblue4", 0xFF104E8B},
+	{"firebrick1", 0xFFFF3030},
+	{"violetred1", 0xFFFF3E96},
+	{"grey32", 0xFF525252},
+	{"thistle", 0xFFD8BFD8},
+	{"olivedrab3", 0xFF9ACD32},
+	{"gray85", 0xFFD9D9D9},
+	{"grey42", 0xFF6B6B6B},
+	{"gray24", 0xFF3D3D3D},
+	{"darkorchid4", 0xFF68228B},
+	{"grey15", 0xFF262626},
+	{"mediumorchid3", 0xFFB452CD},
+	{"green3", 0xFF00CD00},
+	{"grey44", 0xFF707070},
+	{"gray56", 0xFF8F8F8F},
+	{"darkorchid1", 0xFFBF3EFF},
+	{"gray83", 0xFFD4D4D4},
+	{"sienna3", 0xFFCD6839},
+	{"cadetblue", 0xFF5F9EA0},
+	{"grey45", 0xFF737373},
+	{"navajowhite2", 0xFFEECFA1},
+	{"gray16", 0xFF292929},
+	{"darkblue", 0xFF00008B},
+	{"gray91", 0xFFE8E8E8},
+	{"red1", 0xFFFF0000},
+	{"grey77", 0xFFC4C4C4},
+	{"rosybrown1", 0xFFFFC1C1},
+	{"purple1", 0xFF9B30FF},
+	{"gray58", 0xFF949494},
+	{"lightblue4", 0xFF68838B},
+	{"bisque", 0xFFFFE4C4},
+	{"seashell2", 0xFFEEE5DE},
+	{"lightpink1", 0xFFFFAEB9},
+	{"cornsilk4", 0xFF8B8878},
+	{"gray30", 0xFF4D4D4D},
+	{"coral4", 0xFF8B3E2F},
+	{"pink1", 0xFFFFB5C5},
+	{"gray93", 0xFFEDEDED},
+	{"grey67", 0xFFABABAB},
+	{"chartreuse3", 0xFF66CD00},
+	{"ivory", 0xFFFFFFF0},
+	{"gray40", 0xFF666666},
+	{"gray10", 0xFF1A1A1A},
+	{"skyblue4", 0xFF4A708B},
+	{"beige", 0xFFF5F5DC},
+	{"grey95", 0xFFF2F2F2},
+	{"palegreen1", 0xFF9AFF9A},
+	{"limegreen", 0xFF32CD32},
+	{"lightpink3", 0xFFCD8C95},
+	{"mediumblue", 0xFF0000CD},
+	{"palegreen", 0xFF98FB98},
+	{"lemonchiffon", 0xFFFFFACD},
+	{"skyblue1", 0xFF87CEFF},
+	{"gray42", 0xFF6B6B6B},
+	{"grey90", 0xFFE5E5E5},
+	{"blue2", 0xFF0000EE},
+	{"gray59", 0xFF969696},
+	{"lemonchiffon3", 0xFFCDC9A5},
+	{"lightcyan1", 0xFFE0FFFF},
+	{"bisque2", 0xFFEED5B7},
+	{"orchid", 0xFFDA70D6},
+	{"turquoise3", 0xFF00C5CD},
+	{"grey35", 0xFF595959},
+	{"grey36", 0xFF5C5C5C},
+	{"gray88", 0xFFE0E0E0},
+	{"gray74", 0xFFBDBDBD},
+	{"orangered4", 0xFF8B2500},
+	{"green4", 0xFF008B00},
+	{"slategray2", 0xFFB9D3EE},
+	{"darkslategray", 0xFF2F4F4F},
+	{"gray65", 0xFFA6A6A6},
+	{"navajowhite4", 0xFF8B795E},
+	{"gray44", 0xFF707070},
+	{"grey81", 0xFFCFCFCF},
+	{"burlywood3", 0xFFCDAA7D},
+	{"red4", 0xFF8B0000},
+	{"darkorange1", 0xFFFF7F00},
+	{"palevioletred3", 0xFFCD6889},
+	{"brown4", 0xFF8B2323},
+	{"mistyrose", 0xFFFFE4E1},
+	{"floralwhite", 0xFFFFFAF0},
+	{"grey38", 0xFF616161},
+	{"orchid4", 0xFF8B4789},
+	{"grey88", 0xFFE0E0E0},
+	{"springgreen2", 0xFF00EE76},
+	{"ghostwhite", 0xFFF8F8FF},
+	{"grey55", 0xFF8C8C8C},
+	{"darkgrey", 0xFFA9A9A9},
+	{"coral", 0xFFFF7F50},
+	{"red", 0xFFFF0000},
+	{"darkseagreen1", 0xFFC1FFC1},
+	{"cornsilk2", 0xFFEEE8CD},
+	{"tan2", 0xFFEE9A49},
+	{"gray41", 0xFF696969},
+	{"gray50", 0xFF7F7F7F},
+	{"indianred3", 0xFFCD5555},
+	{"indianred1", 0xFFFF6A6A},
+	{"grey70", 0xFFB3B3B3},
+	{"lightcyan4", 0xFF7A8B8B},
+	{"gray48", 0xFF7A7A7A},
+	{"coral3", 0xFFCD5B45},
+	{"gray55", 0xFF8C8C8C},
+	{"mediumorchid4", 0xFF7A378B},
+	{"mediumorchid2", 0xFFD15FEE},
+	{"grey12", 0xFF1F1F1F},
+	{"grey58", 0xFF949494},
+	{"lightyellow", 0xFFFFFFE0},
+	{"darkgoldenrod", 0xFFB8860B},
+	{"azure2", 0xFFE0EEEE},
+	{"deeppink3", 0xFFCD1076},
+	{"thistle4", 0xFF8B7B8B},
+	{"gray71", 0xFFB5B5B5},
+	{"hotpink1", 0xFFFF6EB4},
+	{"gray26", 0xFF424242},
+	{"gray84", 0xFFD6D6D6},
+	{"gray7", 0xFF121212},
+	{"yellowgreen", 0xFF9ACD32},
+	{"darkseagreen", 0xFF8FBC8F},
+	{"grey25", 0xFF404040},
+	{"turquoise4", 0xFF00868B},
+	{"lightskyblue3", 0xFF8DB6CD},
+	{"brown3", 0xFFCD3333},
+	{"slateblue4", 0xFF473C8B},
+	{"gray0", 0xFF000000},
+	{"lightseagreen", 0xFF20B2AA},
+	{"blanchedalmond", 0xFFFFEBCD},
+	{"grey60", 0xFF999999},
+	{"peachpuff4", 0xFF8B7765},
+	{"grey89", 0xFFE3E3E3},
+	{"lightgoldenrod2", 0xFFEEDC82},
+	{"darkorchid2", 0xFFB23AEE},
+	{"forestgreen", 0xFF228B22},
+	{"peachpuff", 0xFFFFDAB9},
+	{"lavender", 0xFFE6E6FA},
+	{"grey39", 0xFF636363},
+	{"grey71", 0xFFB5B5B5},
+	{"darkgreen", 0xFF006400},
+	{"grey41", 0xFF696969},
+	{"palevioletred1", 0xFFFF82AB},
+	{"slategrey", 0xFF708090},
+	{"red2", 0xFFEE0000},
+	{"salmon1", 0xFFFF8C69},
+	{"grey59", 0xFF969696},
+	{"snow", 0xFFFFFAFA},
+	{"lavenderblush3", 0xFFCDC1C5},
+	{"grey27", 0xFF454545},
+	{"darkslateblue", 0xFF483D8B},
+	{"grey52", 0xFF858585},
+	{"lightred", 0xFFFFA0A0},
+	{"honeydew3", 0xFFC1CDC1},
+	{"gray32", 0xFF525252},
+	{"chocolate1", 0xFFFF7F24},
+	{"azure4", 0xFF838B8B},
+	{"green2", 0xFF00EE00},
+	{"plum1", 0xFFFFBBFF},
+	{"magenta", 0xFFFF00FF},
+	{"grey4", 0xFF0A0A0A},
+	{"grey91", 0xFFE8E8E8},
+	{"saddlebrown", 0xFF8B4513},
+	{"purple4", 0xFF551A8B},
+	{"cornsilk3", 0xFFCDC8B1},
+	{"brown2", 0xFFEE3B3B},
+	{"gray80", 0xFFCCCCCC},
+	{"chocolate", 0xFFD2691E},
+	{"antiquewhite3", 0xFFCDC0B0},
+	{"antiquewhite", 0xFFFAEBD7},
+	{"gray61", 0xFF9C9C9C},
+	{"aliceblue", 0xFFF0F8FF},
+	{"violet", 0xFFEE82EE},
+	{"grey37", 0xFF5E5E5E},
+	{"grey19", 0xFF303030},
+	{"gray86", 0xFFDBDBDB},
+	{"teal", 0xFF008080},
+	{"tan1", 0xFFFFA54F},
+	{"grey97", 0xFFF7F7F7},
+	{"firebrick4", 0xFF8B1A1A},
+	{"magenta4", 0xFF8B008B},
+	{"grey10", 0xFF1A1A1A},
+	{"grey23", 0xFF3B3B3B},
+	{"gray21", 0xFF363636},
+	{"gray38", 0xFF616161},
+	{"seashell", 0xFFFFF5EE},
+	{"turquoise2", 0xFF00E5EE},
+	{"tomato", 0xFFFF6347},
+	{"indigo", 0xFF4B0082},
+	{"darkorchid3", 0xFF9A32CD},
+	{"thistle3", 0xFFCDB5CD},
+	{"powderblue", 0xFFB0E0E6},
+	{"webgreen", 0xFF008000},
+	{"yellow4", 0xFF8B8B00},
+	{"grey43", 0xFF6E6E6E},
+	{"cyan3", 0xFF00CDCD},
+	{"skyblue2", 0xFF7EC0EE},
+	{"grey96", 0xFFF5F5F5},
+	{"gainsboro", 0xFFDCDCDC},
+	{"grey20", 0xFF333333},
+	{"lightslategray", 0xFF778899},
+	{"lemonchiffon1", 0xFFFFFACD},
+	{"darkred", 0xFF8B0000},
+	{"grey18", 0xFF2E2E2E},
+	{"grey48", 0xFF7A7A7A},
+	{"grey1", 0xFF030303},
+	{"grey28", 0xFF474747},
+	{"gray79", 0xFFC9C9C9},
+	{"grey22", 0xFF383838},
+	{"khaki", 0xFFF0E68C},
+	{"gray67", 0xFFABABAB},
+	{"khaki3", 0xFFCDC673},
+	{"lightpink", 0xFFFFB6C1},
+	{"burlywood", 0xFFDEB887},
+	{"cyan2", 0xFF00EEEE},
+	{"salmon4", 0xFF8B4C39},
+	{"gray98", 0xFFFAFAFA},
+	{"hotpink2", 0xFFEE6AA7},
+	{"antiquewhite1", 0xFFFFEFDB},
+	{"grey0", 0xFF000000},
+	{"grey46", 0xFF757575},
+	{"honeydew1", 0xFFF0FFF0},
+	{"darkorange", 0xFFFF8C00},
+	{"darkorange3", 0xFFCD6600},
+	{"cornsilk", 0xFFFFF8DC},
+	{"gold1", 0xFFFFD700},
+	{"gray33", 0xFF545454},
+	{"sienna", 0xFFA0522D},
+	{"mediumorchid", 0xFFBA55D3},
+	{"maroon2", 0xFFEE30A7},
+	{"magenta3", 0xFFCD00CD},
+	{"pink2", 0xFFEEA9B8},
+	{"gray68", 0xFFADADAD},
+	{"slategray", 0xFF708090},
+	{"bisque1", 0xFFFFE4C4},
+	{"blue4", 0xFF00008B},
+	{"grey21", 0xFF363636},
+	{"grey30", 0xFF4D4D4D},
+	{"mistyrose2", 0xFFEED5D2},
+	{"palegreen2", 0xFF90EE90},
+	{"palegoldenrod", 0xFFEEE8AA},
+	{"gray81", 0xFFCFCFCF},
+	{"grey68", 0xFFADADAD},
+	{"lightgoldenrodyellow", 0xFFFAFAD2},
+	{"chartreuse1", 0xFF7FFF00},
+	{"grey66", 0xFFA8A8A8},
+	{"gray54", 0xFF8A8A8A},
+	{"lightblue2", 0xFFB2DFEE},
+	{"x11grey", 0xFFBEBEBE},
+	{"lightsteelblue4", 0xFF6E7B8B},
+	{"gray96", 0xFFF5F5F5},
+	{"gray69", 0xFFB0B0B0},
+	{"grey83", 0xFFD4D4D4},
+	{"rebeccapurple", 0xFF663399},
+	{"darkolivegreen", 0xFF556B2F},
+	{"grey74", 0xFFBDBDBD},
+	{"thistle2", 0xFFEED2EE},
+	{"navyblue", 0xFF000080},
+	{"grey92", 0xFFEBEBEB},
+	{"palevioletred", 0xFFDB7093},
+	{"maroon1", 0xFFFF34B3},
+	{"slateblue3", 0xFF6959CD},
+	{"lightgrey", 0xFFD3D3D3},
+	{"gray72", 0xFFB8B8B8},
+	{"indianred", 0xFFCD5C5C},
+	{"lightgreen", 0xFF90EE90},
+	{"lightgoldenrod4", 0xFF8B814C},
+	{"slategray1", 0xFFC6E2FF},
+	{"greenyellow", 0xFFADFF2F},
+	{"lightgoldenrod3", 0xFFCDBE70},
+	{"darkolivegreen1", 0xFFCAFF70},
+	{"mistyrose3", 0xFFCDB7B5},
+	{"aquamarine3", 0xFF66CDAA},
+	{"lightyellow1", 0xFFFFFFE0},
+	{"honeydew2", 0xFFE0EEE0},
+	{"peru", 0xFFCD853F},
+	{"firebrick", 0xFFB22222},
+	{"orangered1", 0xFFFF4500},
+	{"gray52", 0xFF858585},
+	{"gray97", 0xFFF7F7F7},
+	{"dodgerblue2", 0xFF1C86EE},
+	{"gray29", 0xFF4A4A4A},
+	{"darkseagreen3", 0xFF9BCD9B},
+	{"darkolivegreen3", 0xFFA2CD5A},
+	{"steelblue1", 0xFF63B8FF},
+	{"thistle1", 0xFFFFE1FF},
+	{"darkgray", 0xFFA9A9A9},
+	{"grey84", 0xFFD6D6D6},
+	{"grey76", 0xFFC2C2C2},
+	{"yellow1", 0xFFFFFF00},
+	{"darkgoldenrod4", 0xFF8B6508},
+	{"gray53", 0xFF878787},
+	{"lightsalmon4", 0xFF8B5742},
+	{"purple", 0xFFA020F0},
+	{"darkslategray1", 0xFF97FFFF},
+	{"x11gray", 0xFFBEBEBE},
+	{"chartreuse4", 0xFF458B00},
+	{"lightsalmon1", 0xFFFFA07A},
+	{"mediumpurple1", 0xFFAB82FF},
+	{"grey93", 0xFFEDEDED},
+	{"gray66", 0xFFA8A8A8},
+	{"darkgoldenrod3", 0xFFCD950C},
+	{"magenta1", 0xFFFF00FF},
+	{"rosybrown", 0xFFBC8F8F},
+	{"grey65", 0xFFA6A6A6},
+	{"deeppink", 0xFFFF1493},
+	{"papayawhip", 0xFFFFEFD5},
+	{"salmon", 0xFFFA8072},
+	{"honeydew", 0xFFF0FFF0},
+	{"mintcream", 0xFFF5FFFA},
+	{"gray45", 0xFF737373},
+	{"azure1", 0xFFF0FFFF},
+	{"purple2", 0xFF912CEE},
+	{"lightskyblue", 0xFF87CEFA},
+	{"wheat", 0xFFF5DEB3},
+	{"aquamarine4", 0xFF458B74},
+	{"cadetblue2", 0xFF8EE5EE},
+	{"grey98", 0xFFFAFAFA},
+	{"cadetblue1", 0xFF98F5FF},
+	{"cornsilk1", 0xFFFFF8DC},
+	{"darkolivegreen2", 0xFFBCEE68},
+	{"paleturquoise2", 0xFFAEEEEE},
+	{"grey26", 0xFF424242},
+	{"lightslategrey", 0xFF778899},
+	{"chartreuse", 0xFF7FFF00},
+	{"seashell3", 0xFFCDC5BF},
+	{"chocolate2", 0xFFEE7621},
+	{"orange2", 0xFFEE9A00},
+	{"cyan4", 0xFF008B8B},
+	{"gold2", 0xFFEEC900},
+	{"plum2", 0xFFEEAEEE},
+	{"gray51", 0xFF828282},
+	{"lightgoldenrod1", 0xFFFFEC8B},
+	{"mediumpurple2", 0xFF9F79EE},
+	{"paleturquoise1", 0xFFBBFFFF},
+	{"gray99", 0xFFFCFCFC},
+	{"lavenderblush2", 0xFFEEE0E5},
+	{"royalblue4", 0xFF27408B},
+	{"slateblue", 0xFF6A5ACD},
+	{"lightgoldenrod", 0xFFEEDD82},
+	{"cadetblue4", 0xFF53868B},
+	{"gray75", 0xFFBFBFBF},
+	{"lightcyan3", 0xFFB4CDCD},
+	{"silver", 0xFFC0C0C0},
+	{"navy", 0xFF000080},
+	{"gray73", 0xFFBABABA},
+	{"tomato4", 0xFF8B3626},
+	{"wheat4", 0xFF8B7E66},
+	{"goldenrod", 0xFFDAA520},
+	{"deepskyblue", 0xFF00BFFF},
+	{"lightmagenta", 0xFFFFA0F0},
+	{"darkorange2", 0xFFEE7600},
+	{"gray82", 0xFFD1D1D1},
+	{"firebrick2", 0xFFEE2C2C},
+	{"pink", 0xFFFFC0CB},
+	{"orange", 0xFFFFA500},
+	{"seashell1", 0xFFFFF5EE},
+	{"burlywood1", 0xFFFFD39B},
+	{"hotpink3", 0xFFCD6090},
+	{"dodgerblue", 0xFF1E90FF},
+	{"grey50", 0xFF7F7F7F},
+	{"dodgerblue3", 0xFF1874CD},
+	{"gray8", 0xFF141414},
+	{"fuchsia", 0xFFFF00FF},
+	{"gray49", 0xFF7D7D7D},
+	{"chocolate3", 0xFFCD661D},
+	{"dimgray", 0xFF696969},
+	{"orange1", 0xFFFFA500},
+	{"tomato3", 0xFFCD4F39},
+	{"tan3", 0xFFCD853F},
+	{"gold4", 0xFF8B7500},
+	{"x11green", 0xFF00FF00},
+	{"gray4", 0xFF0A0A0A},
+	{"grey5", 0xFF0D0D0D},
+	{"tan", 0xFFD2B48C},
+	{"gray6", 0xFF0F0F0F},
+	{"maroon4", 0xFF8B1C62},
+	{"darkorange4", 0xFF8B4500},
+	{"gray43", 0xFF6E6E6E},
+	{"ivory4", 0xFF8B8B83},
+	{"grey49", 0xFF7D7D7D},
+	{"grey", 0xFFBEBEBE},
+	{"peachpuff3", 0xFFCDAF95},
+	{"midnightblue", 0xFF191970},
+	{"rosybrown2", 0xFFEEB4B4},
+	{"lightpink2", 0xFFEEA2AD},
+	{"gray1", 0xFF030303},
+	{"gray77", 0xFFC4C4C4},
+	{"palegreen3", 0xFF7CCD7C},
+	{"palevioletred2", 0xFFEE799F},
+	{"orangered", 0xFFFF4500},
+	{"lightslateblue", 0xFF8470FF},
+	{"royalblue1", 0xFF4876FF},
+	{"steelblue", 0xFF4682B4},
+	{"bisque3", 0xFFCDB79E},
+	{"gray63", 0xFFA1A1A1},
+	{"lightskyblue4", 0xFF607B8B},
+	{"lightsteelblue", 0xFFB0C4DE},
+	{"violetred", 0xFFD02090},
+	{"navajowhite3", 0xFFCDB38B},
+	{"mediumorchid1", 0xFFE066FF},
+	{"aquamarine", 0xFF7FFFD4},
+	{"orchid1", 0xFFFF83FA},
+	{"coral1", 0xFFFF7256},
+	{"steelblue2", 0xFF5CACEE},
+	{"goldenrod1", 0xFFFFC125},
+	{"mediumturquoise", 0xFF48D1CC},
+	{"grey64", 0xFFA3A3A3},
+	{"honeydew4", 0xFF838B83},
+	{"khaki1", 0xFFFFF68F},
+	{"gray28", 0xFF474747},
+	{"orchid2", 0xFFEE7AE9},
+	{"grey51", 0xFF828282},
+	{"black", 0xFF000000},
+	{"mediumspringgreen", 0xFF00FA9A},
+	{"slategray3", 0xFF9FB6CD},
+	{"gray47", 0xFF787878},
+	{"lightyellow4", 0xFF8B8B7A},
+	{"gray62", 0xFF9E9E9E},
+	{"mediumslateblue", 0xFF7B68EE},
+	{"springgreen", 0xFF00FF7F},
+	{"green1", 0xFF00FF00},
+	{"lavenderblush1", 0xFFFFF0F5},
+	{"grey86", 0xFFDBDBDB},
+	{"pink3", 0xFFCD919E},
+	{"deepskyblue3", 0xFF009ACD},
+	{"darksalmon", 0xFFE9967A},
+	{"gray9", 0xFF171717},
+	{"gray2", 0xFF050505},
+	{"chartreuse2", 0xFF76EE00},
+	{"seagreen2", 0xFF4EEE94},
+	{"gray78", 0xFFC7C7C7},
+	{"darkolivegreen4", 0xFF6E8B3D},
+	{"webmaroon", 0xFF800000},
+	{"snow3", 0xFFCDC9C9},
+	{"aqua", 0xFF00FFFF},
+	{"grey73", 0xFFBABABA},
+	{"lavenderblush4", 0xFF8B8386},
+	{"mistyrose4", 0xFF8B7D7B},
+	{"lemonchiffon4", 0xFF8B8970},
+	{"grey29", 0xFF4A4A4A},
+	{"wheat2", 0xFFEED8AE},
+	{"darkgoldenrod2", 0xFFEEAD0E},
+	{"lightcyan2", 0xFFD1EEEE},
+	{"lightpink4", 0xFF8B5F65},
+	{"darkturquoise", 0xFF00CED1},
+	{"lavenderblush", 0xFFFFF0F5},
+	{"darkmagenta", 0xFF8B008B},
+	{"yellow3", 0xFFCDCD00},
+	{"violetred4", 0xFF8B2252},
+	{"webgray", 0xFF808080},
+	{"lightsteelblue1", 0xFFCAE1FF},
+	{"turquoise", 0xFF40E0D0},
+	{"tomato1", 0xFFFF6347},
+	{"moccasin", 0xFFFFE4B5},
+	{"slateblue1", 0xFF836FFF},
+	{"springgreen1", 0xFF00FF7F},
+	{"gray60", 0xFF999999},
+	{"goldenrod3", 0xFFCD9B1D},
+	{"olive", 0xFF808000},
+	{"blue3", 0xFF0000CD},
+	{"orange4", 0xFF8B5A00},
+	{"gray95", 0xFFF2F2F2},
+	{"grey31", 0xFF4F4F4F},
+	{"grey79", 0xFFC9C9C9},
+	{"lightskyblue2", 0xFFA4D3EE},
+	{"webgrey", 0xFF808080},
+	{"aquamarine2", 0xFF76EEC6},
+	{"grey85", 0xFFD9D9D9},
+	{"violetred3", 0xFFCD3278},
+	{"blue1", 0xFF0000FF},
+	{"grey11", 0xFF1C1C1C},
+	{"grey9", 0xFF171717},
+	{"peachpuff2", 0xFFEECBAD},
+	{"plum3", 0xFFCD96CD},
+	{"lightsalmon", 0xFFFFA07A},
+	{"mediumseagreen", 0xFF3CB371},
+	{"grey47", 0xFF787878},
+	{"lemonchiffon2", 0xFFEEE9BF},
+	{"lightblue", 0xFFADD8E6},
+	{"gray13", 0xFF212121},
+	{"salmon3", 0xFFCD7054},
+	{"lightcyan", 0xFFE0FFFF},
+	{"lightgray", 0xFFD3D3D3},
+	{"palevioletred4", 0xFF8B475D},
+	{"gray3", 0xFF080808},
+	{"lightskyblue1", 0xFFB0E2FF},
+	{"grey57", 0xFF919191},
+	{"khaki4", 0xFF8B864E},
+	{"deeppink2", 0xFFEE1289},
+	{"salmon2", 0xFFEE8262},
+	{"magenta2", 0xFFEE00EE},
+	{"mediumvioletred", 0xFFC71585},
+	{"peachpuff1", 0xFFFFDAB9},
+	{"grey40", 0xFF666666},
+	{"deeppink4", 0xFF8B0A50},
+	{"snow1", 0xFFFFFAFA},
+	{"royalblue3", 0xFF3A5FCD},
+	{"paleturquoise4", 0xFF668B8B},
+	{"wheat1", 0xFFFFE7BA},
+	{"grey61", 0xFF9C9C9C},
+	{"grey100", 0xFFFFFFFF},
+	{"gray92", 0xFFEBEBEB},
+	{"khaki2", 0xFFEEE685},
+	{"seagreen1", 0xFF54FF9F},
+	{"grey63", 0xFFA1A1A1},
+	{"gray64", 0xFFA3A3A3},
+	{"gray23", 0xFF3B3B3B},
+	{"royalblue", 0xFF4169E1},
+	{"grey87", 0xFFDEDEDE},
+	{"grey13", 0xFF212121},
+	{"dimgrey", 0xFF696969},
+	{"skyblue3", 0xFF6CA6CD},
+	{"webpurple", 0xFF800080},
+	{"skyblue", 0xFF87CEEB},
+	{"grey3", 0xFF080808},
+	{"yellow2", 0xFFEEEE00},
+	{"palegreen4", 0xFF548B54},
+	{"gray100", 0xFFFFFFFF},
+	{"gray22", 0xFF383838},
+	{"gray5", 0xFF0D0D0D},
+	{"rosybrown4", 0xFF8B6969},
+	{"grey33", 0xFF545454},
+	{"slategray4", 0xFF6C7B8B},
+	{"orchid3", 0xFFCD69C9},
+	{"rosybrown3", 0xFFCD9B9B},
+	{"burlywood2", 0xFFEEC591},
+	{"lightblue3", 0xFF9AC0CD},
+	{"mediumaquamarine", 0xFF66CDAA},
+	{"white", 0xFFFFFFFF},
+	{"lime", 0xFF00FF00},
+	{"gray94", 0xFFF0F0F0},
+	{"gold3", 0xFFCDAD00},
+	{"olivedrab2", 0xFFB3EE3A},
+	{"gray70", 0xFFB3B3B3},
+	{"purple3", 0xFF7D26CD},
+	{"olivedrab1", 0xFFC0FF3E},
+	{"darkslategray3", 0xFF79CDCD},
+	{"goldenrod2", 0xFFEEB422},
+	{"gray36", 0xFF5C5C5C},
+	{"gray37", 0xFF5E5E5E},
+	{"navajowhite", 0xFFFFDEAD},
+	{"lightcoral", 0xFFF08080},
+	{"darkseagreen2", 0xFFB4EEB4},
+	{"lightblue1", 0xFFBFEFFF},
+	{"snow2", 0xFFEEE9E9},
+	{"lightsalmon3", 0xFFCD8162},
+	{"blueviolet", 0xFF8A2BE2},
+	{"darkcyan", 0xFF008B8B},
+	{"seagreen3", 0xFF43CD80},
+	{"deeppink1", 0xFFFF1493},
+	{"azure3", 0xFFC1CDCD},
+	{"linen", 0xFFFAF0E6},
+	{"grey82", 0xFFD1D1D1},
+	{"ivory2", 0xFFEEEEE0},
+	{"darkgoldenrod1", 0xFFFFB90F},
+	{"orangered2", 0xFFEE4000},
+	{"grey75", 0xFFBFBFBF},
+	{"aquamarine1", 0xFF7FFFD4},
+	{"x11purple", 0xFFA020F0},
+	{"mistyrose1", 0xFFFFE4E1},
+	{"gray34", 0xFF575757},
+	{"darkslategray2", 0xFF8DEEEE},
+	{"maroon3", 0xFFCD2990},
+	{"gray20", 0xFF333333},
+	{"lawngreen", 0xFF7CFC00},
+	{"brown1", 0xFFFF4040},
+	{"lightyellow3", 0xFFCDCDB4},
+	{"azure", 0xFFF0FFFF},
+	{"grey62", 0xFF9E9E9E},
+	{"gray27", 0xFF454545},
+	{"pink4", 0xFF8B636C},
+	{"red3", 0xFFCD0000},
+	{"darkslategray4", 0xFF528B8B},
+	{"coral2", 0xFFEE6A50},
+	{"tomato2", 0xFFEE5C42},
+	{"dodgerblue1", 0xFF1E90FF},
+	{"grey69", 0xFFB0B0B0},
+	{"yellow", 0xFFFFFF00},
+	{"darkseagreen4", 0xFF698B69},
+	{"ivory1", 0xFFFFFFF0},
+	{"plum4", 0xFF8B668B},
+	{"grey17", 0xFF2B2B2B},
+};
@@ -0,0 +1,258 @@
+#include "drawtrace.h"
+#include "qvimshell.h"
+
+#include <QApplication>
+#include <QElapsedTimer>
+
+DrawTrace::DrawTrace()
+{
+}
+
+/**
+ * Start recording into fname, returns false if the
+ * file cannot be written
+ */
+bool DrawTrace::open(const QString& fname)
+{
+	m_file.setFileName(fname);
+	if ( !m_file.open(QIODevice::WriteOnly | QIODevice::Truncate) ) {
+		return false;
+	}
+
+	m_stream.setDevice(&m_file);
+	m_stream.setVersion(QDataStream::Qt_4_6);
+	m_stream << Magic << Version;
+	return true;
+}
+
+void DrawTrace::block(int row1, int col1, int row2, int col2)
+{
+	m_stream << (qint16)row1 << (qint16)col1 << (qint16)row2 << (qint16)col2;
+}
+
+void DrawTrace::resize(int rows, int columns, int charWidth, int charHeight,
+			int ascent, const QFont& font)
+{
+	m_stream << (quint8)Resize << (qint16)rows << (qint16)columns
+		<< (qint16)charWidth << (qint16)charHeight << (qint16)ascent
+		<< font.toString();
+}
+
+void DrawTrace::clear(QRgb bg)
+{
+	m_stream << (quint8)Clear << bg;
+}
+
+void DrawTrace::clearBlock(int row1, int col1, int row2, int col2, QRgb bg)
+{
+	m_stream << (quint8)ClearBlock;
+	block(row1, col1, row2, col2);
+	m_stream << bg;
+}
+
+void DrawTrace::drawString(int row, int col, const QString& str, int flags,
+			QRgb fg, QRgb bg, QRgb sp, bool wide)
+{
+	m_stream << (quint8)DrawString << (qint16)row << (qint16)col
+		<< (quint8)flags << (quint8)wide << fg << bg << sp << str.toUtf8();
+}
+
+void DrawTrace::drawSign(int row, int col, int typenr)
+{
+	m_stream << (quint8)DrawSign << (qint16)row << (qint16)col << (qint32)typenr;
+}
+
+void DrawTrace::invertBlock(int row1, int col1, int row2, int col2)
+{
+	m_stream << (quint8)Invert;
+	block(row1, col1, row2, col2);
+}
+
+void DrawTrace::scrollRows(int row1, int row2, int col1, int col2, int count, QRgb bg)
+{
+	m_stream << (quint8)Scroll;
+	block(row1, col1, row2, col2);
+	m_stream << (qint16)count << bg;
+}
+
+void DrawTrace::partCursor(const QRect& rect, QRgb color)
+{
+	m_stream << (quint8)PartCursor << rect << color;
+}
+
+void DrawTrace::hollowCursor(const QRect& rect, QRgb color)
+{
+	m_stream << (quint8)HollowCursor << rect << color;
+}
+
+void DrawTrace::flush()
+{
+	m_stream << (quint8)Flush;
+}
+
+const char * DrawTrace::opName(int op)
+{
+	switch(op) {
+	case Resize: return "resize";
+	case Clear: return "clear";
+	case ClearBlock: return "clear_block";
+	case DrawString: return "draw_string";
+	case DrawSign: return "draw_sign";
+	case Invert: return "invert";
+	case Scroll: return "scroll";
+	case PartCursor: return "part_cursor";
+	case HollowCursor: return "hollow_cursor";
+	case Flush: return "flush";
+	}
+	return "unknown";
+}
+
+/**
+ * Replay a trace into the shell as fast as possible, every Flush
+ * presents a frame and paints it right away.
+ *
+ * Vim's shell size and font metrics are overwritten with the ones
+ * in the trace. Returns a text report with the frame rate and the
+ * average cost of each kind of call, or an empty string if the
+ * file is not a valid trace.
+ */
+QString DrawTrace::replay(const QString& fname, QVimShell *shell)
+{
+	QFile file(fname);
+	if ( !file.open(QIODevice::ReadOnly) ) {
+		return QString();
+	}
+
+	QDataStream in(&file);
+	in.setVersion(QDataStream::Qt_4_6);
+	quint32 magic, version;
+	in >> magic >> version;
+	if ( magic != Magic || version != Version ) {
+		return QString();
+	}
+
+	qint64 opTime[OpCount], opCount[OpCount];
+	for (int i=0; i<OpCount; i++) {
+		opTime[i] = opCount[i] = 0;
+	}
+
+	shell->stats().reset();
+	QElapsedTimer clock;
+	clock.start();
+
+	while ( !in.atEnd() && in.status() == QDataStream::Ok ) {
+		quint8 op;
+		qint16 row1, col1, row2, col2, count;
+		quint8 flags, wide;
+		qint32 typenr;
+		QRgb fg, bg, sp;
+		QRect rect;
+		QByteArray text;
+		QString font;
+
+		in >> op;
+		if ( op == 0 || op >= OpCount ) {
+			break;
+		}
+
+		// Read the arguments first, only the shell call is timed
+		switch(op) {
+		case Resize:
+			in >> row1 >> col1 >> row2 >> col2 >> count >> font;
+			break;
+		case Clear:
+			in >> bg;
+			break;
+		case ClearBlock:
+			in >> row1 >> col1 >> row2 >> col2 >> bg;
+			break;
+		case DrawString:
+			in >> row1 >> col1 >> flags >> wide >> fg >> bg >> sp >> text;
+			break;
+		case DrawSign:
+			in >> row1 >> col1 >> typenr;
+			break;
+		case Invert:
+			in >> row1 >> col1 >> row2 >> col2;
+			break;
+		case Scroll:
+			in >> row1 >> col1 >> row2 >> col2 >> count >> bg;
+			break;
+		case PartCursor:
+		case HollowCursor:
+			in >> rect >> fg;
+			break;
+		}
+		if ( in.status() != QDataStream::Ok ) {
+			break;
+		}
+
+		qint64 start = clock.nsecsElapsed();
+		switch(op) {
+		case Resize:
+			{
+			QFont f;
+			f.fromString(font);
+			gui.num_rows = row1;
+			gui.num_cols = col1;
+			gui.char_width = row2;
+			gui.char_height = col2;
+			gui.char_ascent = count;
+			shell->setShellFont(f);
+			shell->setCharWidth(gui.char_width);
+			shell->window()->resize(col1*row2, row1*col2);
+			}
+			break;
+		case Clear:
+			shell->clearAll(bg);
+			break;
+		case ClearBlock:
+			shell->clearBlock(row1, col1, row2, col2, bg);
+			break;
+		case DrawString:
+			shell->selectWideFont(wide);
+			shell->drawString(row1, col1, QString::fromUtf8(text), flags, fg, bg, sp);
+			break;
+		case DrawSign:
+			shell->drawSign(row1, col1, typenr);
+			break;
+		case Invert:
+			shell->invertBlock(row1, col1, row2, col2);
+			break;
+		case Scroll:
+			shell->scrollRows(row1, row2, col1, col2, count, bg);
+			break;
+		case PartCursor:
+			shell->drawPartCursor(rect, fg);
+			break;
+		case HollowCursor:
+			shell->drawHollowCursor(rect, fg);
+			break;
+		case Flush:
+			shell->presentPending();
+			QApplication::processEvents();
+			break;
+		}
+		opTime[op] += clock.nsecsElapsed() - start;
+		opCount[op]++;
+	}
+
+	qint64 elapsed = qMax(clock.elapsed(), (qint64)1);
+	const PaintStats& stats = shell->stats();
+
+	QString report;
+	report += QString("trace %1\n").arg(fname);
+	report += QString("frames %1 time_ms %2 fps %3\n")
+			.arg(stats.frames()).arg(elapsed)
+			.arg(stats.frames()*1000.0/elapsed, 0, 'f', 1);
+	report += "frame_us " + stats.frameTime().toString() + "\n";
+	report += "cells_per_frame " + stats.cellsPerFrame().toString() + "\n";
+	for (int i=1; i<OpCount; i++) {
+		if ( opCount[i] == 0 ) {
+			continue;
+		}
+		report += QString("%1 count %2 avg_ns %3\n").arg(opName(i))
+				.arg(opCount[i]).arg(opTime[i]/opCount[i]);
+	}
+	return report;
+}
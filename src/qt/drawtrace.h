@@ -0,0 +1,56 @@
+#ifndef __VIM_QT_DRAWTRACE__
+#define __VIM_QT_DRAWTRACE__
+
+#include <QFile>
+#include <QDataStream>
+#include <QFont>
+#include <QRect>
+#include <QColor>
+
+class QVimShell;
+
+/**
+ * DrawTrace records the drawing calls made to the shell in a compact
+ * binary file. The trace can be replayed into a shell to benchmark the
+ * paint pipeline without running Vim, see replay().
+ *
+ * The file starts with a magic number and a version, followed by
+ * one record per call - an Op and its arguments.
+ */
+class DrawTrace
+{
+public:
+	enum Op { Resize=1, Clear, ClearBlock, DrawString, DrawSign,
+		Invert, Scroll, PartCursor, HollowCursor, Flush, OpCount };
+
+	DrawTrace();
+	bool open(const QString& fname);
+
+	void resize(int rows, int columns, int charWidth, int charHeight,
+			int ascent, const QFont& font);
+	void clear(QRgb bg);
+	void clearBlock(int row1, int col1, int row2, int col2, QRgb bg);
+	void drawString(int row, int col, const QString& str, int flags,
+			QRgb fg, QRgb bg, QRgb sp, bool wide);
+	void drawSign(int row, int col, int typenr);
+	void invertBlock(int row1, int col1, int row2, int col2);
+	void scrollRows(int row1, int row2, int col1, int col2, int count, QRgb bg);
+	void partCursor(const QRect& rect, QRgb color);
+	void hollowCursor(const QRect& rect, QRgb color);
+	void flush();
+
+	static QString replay(const QString& fname, QVimShell *shell);
+
+protected:
+	void block(int row1, int col1, int row2, int col2);
+	static const char *opName(int op);
+
+private:
+	static const quint32 Magic = 0x51565452;
+	static const quint32 Version = 1;
+
+	QFile m_file;
+	QDataStream m_stream;
+};
+
+#endif
@@ -0,0 +1,76 @@
+#include "fontcache.h"
+#include "shellgrid.h"
+
+FontCache::FontCache()
+:m_hasWide(false), m_hits(0), m_misses(0)
+{
+	setFont(QFont());
+}
+
+/**
+ * Fill styles with the eight style variants of font, indexed by
+ * ShellCell::Bold, Italic and Underline
+ */
+void FontCache::resolve(const QFont& font, QFont *styles)
+{
+	for (int i=0; i<8; i++) {
+		QFont f = font;
+		f.setBold( i & ShellCell::Bold );
+		f.setItalic( i & ShellCell::Italic );
+		f.setUnderline( i & ShellCell::Underline );
+		styles[i] = f;
+	}
+}
+
+/**
+ * Set the shell font, the variants are only resolved if
+ * the font changed - returns true in that case
+ */
+bool FontCache::setFont(const QFont& font)
+{
+	if ( !m_metrics.isEmpty() && font == m_styles[0] ) {
+		m_hits++;
+		return false;
+	}
+	m_misses++;
+
+	resolve(font, m_styles);
+	m_metrics.clear();
+	for (int i=0; i<8; i++) {
+		m_metrics.append(QFontMetrics(m_styles[i]));
+	}
+	return true;
+}
+
+/**
+ * Set the font for double width characters ('guifontwide')
+ */
+bool FontCache::setWideFont(const QFont& font)
+{
+	if ( m_hasWide && font == m_wide[0] ) {
+		m_hits++;
+		return false;
+	}
+	m_misses++;
+
+	resolve(font, m_wide);
+	m_hasWide = true;
+	return true;
+}
+
+/**
+ * The font variant for the given ShellCell style flags, if wide is
+ * true the 'guifontwide' variant is used when there is one
+ */
+const QFont& FontCache::font(uchar flags, bool wide) const
+{
+	if ( wide && m_hasWide ) {
+		return m_wide[flags & 0x07];
+	}
+	return m_styles[flags & 0x07];
+}
+
+const QFontMetrics& FontCache::metrics(uchar flags) const
+{
+	return m_metrics.at(flags & 0x07);
+}
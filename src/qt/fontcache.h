@@ -0,0 +1,41 @@
+#ifndef __VIM_QT_FONTCACHE__
+#define __VIM_QT_FONTCACHE__
+
+#include <QFont>
+#include <QFontMetrics>
+#include <QList>
+
+/**
+ * FontCache keeps the style variants of the shell fonts
+ *
+ * Vim draws text as bold, italic and underlined (see ShellCell), the
+ * eight combinations of these are resolved once when a font is set,
+ * along with their metrics. The same goes for 'guifontwide'.
+ */
+class FontCache
+{
+public:
+	FontCache();
+
+	bool setFont(const QFont& font);
+	bool setWideFont(const QFont& font);
+
+	const QFont& normalFont() const { return m_styles[0]; }
+	const QFont& font(uchar flags, bool wide=false) const;
+	const QFontMetrics& metrics(uchar flags) const;
+
+	qint64 hits() const { return m_hits; }
+	qint64 misses() const { return m_misses; }
+
+protected:
+	static void resolve(const QFont& font, QFont *styles);
+
+private:
+	QFont m_styles[8];
+	QFont m_wide[8];
+	bool m_hasWide;
+	QList<QFontMetrics> m_metrics;
+	qint64 m_hits, m_misses;
+};
+
+#endif
@@ -0,0 +1,115 @@
+#include "fontprobe.h"
+
+#include <QApplication>
+#include <QDesktopWidget>
+#include <QSettings>
+#include <QFileInfo>
+#include <QDateTime>
+#include <QDir>
+#include <QUrl>
+#include <QStringList>
+
+FontProbe::FontProbe()
+:valid(false), fakeMonospace(false), width(0), lineSpacing(0),
+	ascent(0), descent(0), leading(0), underlinePos(0), lineWidth(0)
+{
+}
+
+void FontProbe::setMetrics(const QFontMetrics& metrics)
+{
+	width = metrics.width("M");
+	lineSpacing = metrics.lineSpacing();
+	ascent = metrics.ascent();
+	descent = metrics.descent();
+	leading = metrics.leading();
+	underlinePos = metrics.underlinePos();
+	lineWidth = metrics.lineWidth();
+}
+
+/**
+ * The font cache file, it is emptied if the generation it
+ * was written for is not the current one
+ */
+QSettings* FontProbeCache::settings()
+{
+	static QSettings *cache = NULL;
+	if ( cache ) {
+		return cache;
+	}
+
+	QSettings ini(QSettings::IniFormat, QSettings::UserScope, "Vim", "qVim");
+	QString path = QFileInfo(ini.fileName()).absoluteDir().absoluteFilePath("qVim.fonts");
+	cache = new QSettings(path, QSettings::IniFormat);
+
+	QString gen = generation();
+	if ( cache->value("generation").toString() != gen ) {
+		cache->clear();
+		cache->setValue("generation", gen);
+	}
+	return cache;
+}
+
+/**
+ * Anything that changes how fonts are resolved, fontconfig
+ * touches these directories when fonts are installed or
+ * its cache is rebuilt
+ */
+QString FontProbeCache::generation()
+{
+	QStringList dirs;
+	dirs << "/etc/fonts" << "/usr/share/fonts" << "/usr/local/share/fonts"
+		<< "/var/cache/fontconfig"
+		<< QDir::home().filePath(".fonts")
+		<< QDir::home().filePath(".local/share/fonts")
+		<< QDir::home().filePath(".cache/fontconfig");
+
+	QString gen = QString("%1 %2").arg(QT_VERSION_STR)
+			.arg(QApplication::desktop()->logicalDpiY());
+	foreach(const QString& dir, dirs) {
+		QFileInfo info(dir);
+		if ( info.exists() ) {
+			gen += QString(" %1").arg(info.lastModified().toTime_t());
+		}
+	}
+	return gen;
+}
+
+QString FontProbeCache::key(const QString& name)
+{
+	// QSettings treats slashes as group separators, and
+	// the default font has an empty name
+	return "fonts/_" + QString::fromLatin1(QUrl::toPercentEncoding(name));
+}
+
+/**
+ * Find the probe for a font name, returns false if there is none
+ */
+bool FontProbeCache::lookup(const QString& name, FontProbe *probe)
+{
+	QStringList fields = settings()->value(key(name)).toStringList();
+	if ( fields.size() != 9 ) {
+		return false;
+	}
+
+	probe->valid = fields.at(0).toInt();
+	probe->fakeMonospace = fields.at(1).toInt();
+	probe->width = fields.at(2).toInt();
+	probe->lineSpacing = fields.at(3).toInt();
+	probe->ascent = fields.at(4).toInt();
+	probe->descent = fields.at(5).toInt();
+	probe->leading = fields.at(6).toInt();
+	probe->underlinePos = fields.at(7).toInt();
+	probe->lineWidth = fields.at(8).toInt();
+	return true;
+}
+
+void FontProbeCache::insert(const QString& name, const FontProbe& probe)
+{
+	QStringList fields;
+	fields << QString::number(probe.valid) << QString::number(probe.fakeMonospace)
+		<< QString::number(probe.width) << QString::number(probe.lineSpacing)
+		<< QString::number(probe.ascent) << QString::number(probe.descent)
+		<< QString::number(probe.leading) << QString::number(probe.underlinePos)
+		<< QString::number(probe.lineWidth);
+	settings()->setValue(key(name), fields);
+}
@@ -0,0 +1,50 @@
+#ifndef __VIM_QT_FONTPROBE__
+#define __VIM_QT_FONTPROBE__
+
+#include <QFont>
+#include <QFontMetrics>
+#include <QString>
+
+class QSettings;
+
+/**
+ * FontProbe is what Vim needs to know about a font before using it
+ *
+ * - if the font was found and has a fixed pitch
+ * - if it only pretends to be monospace (VimWrapper::isFakeMonospace)
+ * - the raw metrics used to compute the cell size
+ */
+class FontProbe
+{
+public:
+	FontProbe();
+
+	void setMetrics(const QFontMetrics& metrics);
+	bool hasMetrics() const { return width > 0; }
+
+	bool valid;
+	bool fakeMonospace;
+	int width, lineSpacing, ascent, descent, leading;
+	int underlinePos, lineWidth;
+};
+
+/**
+ * FontProbeCache keeps font probes on disk, next to the qVim settings
+ *
+ * Resolving a font through the font system can take tens of ms. The
+ * cache is keyed by the font name, and thrown away when the Qt version,
+ * the screen resolution or the font directories change.
+ */
+class FontProbeCache
+{
+public:
+	static bool lookup(const QString& name, FontProbe *probe);
+	static void insert(const QString& name, const FontProbe& probe);
+
+protected:
+	static QSettings* settings();
+	static QString generation();
+	static QString key(const QString& name);
+};
+
+#endif
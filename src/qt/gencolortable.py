@@ -0,0 +1,85 @@
+# Generate the color name table in qt/colortabledata.h from runtime/rgb.txt
+#
+# The color names are stored in a perfect hash table, lookups hash the
+# name once and compare against a single entry (see qt/colortable.cpp).
+#
+# Usage: python qt/gencolortable.py ../runtime/rgb.txt > qt/colortabledata.h
+
+import sys
+
+# For some reason these are not in rgb.txt
+EXTRA_COLORS = [
+	("lightmagenta", (255, 160, 240)),
+	("lightred", (255, 160, 160)),
+]
+
+def normalize(name):
+	return name.replace(" ", "").lower()
+
+def color_hash(seed, name):
+	"""FNV-1a, must match colorHash() in colortable.cpp"""
+	h = (2166136261 ^ seed) & 0xFFFFFFFF
+	for c in name:
+		h ^= ord(c)
+		h = (h * 16777619) & 0xFFFFFFFF
+	return h
+
+def read_colors(path):
+	colors = dict(EXTRA_COLORS)
+	for line in open(path):
+		fields = line.split()
+		if len(fields) < 4 or line.startswith("!"):
+			continue
+		name = normalize(" ".join(fields[3:]))
+		colors[name] = tuple(int(v) for v in fields[:3])
+	return colors
+
+def build_table(names):
+	"""Hash and displace, returns the bucket seeds and the slot for
+	every name"""
+	size = len(names)
+	nbuckets = (size + 3) // 4
+	buckets = [[] for i in range(nbuckets)]
+	for name in names:
+		buckets[color_hash(0, name) % nbuckets].append(name)
+
+	seeds = [0] * nbuckets
+	slots = [None] * size
+	for b in sorted(range(nbuckets), key=lambda b: -len(buckets[b])):
+		keys = buckets[b]
+		if not keys:
+			continue
+		seed = 1
+		while True:
+			taken = [color_hash(seed, k) % size for k in keys]
+			if len(set(taken)) == len(taken) and \
+					all(slots[t] is None for t in taken):
+				break
+			seed += 1
+		seeds[b] = seed
+		for k, t in zip(keys, taken):
+			slots[t] = k
+	return seeds, slots
+
+def main():
+	colors = read_colors(sys.argv[1])
+	seeds, slots = build_table(sorted(colors))
+
+	out = sys.stdout
+	out.write("/*\n * DONT EDIT - auto generated from rgb.txt by qt/gencolortable.py\n */\n")
+	out.write("static const int colorTableSize = %d;\n" % len(slots))
+	out.write("static const int colorSeedCount = %d;\n\n" % len(seeds))
+
+	out.write("static const unsigned short colorSeeds[] = {\n")
+	for i in range(0, len(seeds), 12):
+		out.write("\t" + ", ".join(str(s) for s in seeds[i:i+12]) + ",\n")
+	out.write("};\n\n")
+
+	out.write("static const struct {\n\tconst char *name;\n\tQRgb rgb;\n} colorEntries[] = {\n")
+	for name in slots:
+		r, g, b = colors[name]
+		out.write("\t{\"%s\", 0xFF%02X%02X%02X},\n" % (name, r, g, b))
+	out.write("};\n")
+
+if __name__ == "__main__":
+	main()
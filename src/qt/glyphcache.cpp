@@ -0,0 +1,110 @@
+#include "glyphcache.h"
+
+#include <QtCore/qmath.h>
+
+GlyphCache::GlyphCache()
+:m_width(0), m_height(0), m_ascent(0), m_ratio(1.0), m_hits(0), m_misses(0)
+{
+}
+
+/**
+ * Set the font, cell metrics and device pixel ratio used
+ * to render glyphs
+ *
+ * The cache is emptied if anything changed, returns true in
+ * that case
+ */
+bool GlyphCache::setFont(const FontCache& fonts, int width, int height, int ascent, qreal ratio)
+{
+	if ( width == m_width && height == m_height && ascent == m_ascent
+			&& ratio == m_ratio && fonts.normalFont() == m_font ) {
+		return false;
+	}
+
+	m_font = fonts.normalFont();
+	m_width = width;
+	m_height = height;
+	m_ascent = ascent;
+	m_ratio = ratio;
+
+	for (int i=0; i<8; i++) {
+		m_styles[i] = fonts.font(i);
+	}
+
+	m_atlas = QImage();
+	clear();
+	return true;
+}
+
+void GlyphCache::clear()
+{
+	m_slots.clear();
+}
+
+/**
+ * Find the atlas slot for a glyph, rendering it if needed
+ */
+QRect GlyphCache::glyph(uint ch, uchar flags, QRgb fg)
+{
+	GlyphKey key;
+	key.ch = ch;
+	key.fg = fg;
+	key.flags = flags;
+
+	int slot = m_slots.value(key, -1);
+	if ( slot != -1 ) {
+		m_hits++;
+		return QRect((slot % AtlasColumns)*m_width, (slot / AtlasColumns)*m_height,
+				m_width, m_height);
+	}
+
+	m_misses++;
+	if ( m_atlas.isNull() ) {
+		m_atlas = QImage(qCeil(AtlasColumns*m_width*m_ratio),
+				qCeil(AtlasRows*m_height*m_ratio),
+				QImage::Format_ARGB32_Premultiplied);
+#if QT_VERSION >= 0x050000
+		m_atlas.setDevicePixelRatio(m_ratio);
+#endif
+	}
+	if ( m_slots.size() == AtlasColumns*AtlasRows ) {
+		clear();
+	}
+
+	slot = m_slots.size();
+	m_slots.insert(key, slot);
+
+	QRect rect((slot % AtlasColumns)*m_width, (slot / AtlasColumns)*m_height,
+			m_width, m_height);
+
+	QPainter p(&m_atlas);
+	p.setCompositionMode(QPainter::CompositionMode_Source);
+	p.fillRect(rect, Qt::transparent);
+	p.setCompositionMode(QPainter::CompositionMode_SourceOver);
+	p.setClipRect(rect);
+	p.setFont(m_styles[flags & 0x07]);
+	p.setPen(QColor(fg));
+	p.drawText(QPoint(rect.left(), rect.top() + m_ascent),
+			QString::fromUcs4(&ch, 1));
+
+	return rect;
+}
+
+/**
+ * Draw a glyph with its top left corner at pos
+ */
+void GlyphCache::draw(QPainter& painter, const QPoint& pos, uint ch, uchar flags, QRgb fg)
+{
+	if ( m_width <= 0 || m_height <= 0 ) {
+		return;
+	}
+
+	QRect source = glyph(ch, flags, fg);
+	if ( m_ratio == 1.0 ) {
+		painter.drawImage(pos, m_atlas, source);
+	} else {
+		QRectF device(source.x()*m_ratio, source.y()*m_ratio,
+				m_width*m_ratio, m_height*m_ratio);
+		painter.drawImage(QRectF(pos, QSizeF(m_width, m_height)), m_atlas, device);
+	}
+}
@@ -0,0 +1,68 @@
+#ifndef __VIM_QT_GLYPHCACHE__
+#define __VIM_QT_GLYPHCACHE__
+
+#include <QFont>
+#include <QHash>
+#include <QImage>
+#include <QPainter>
+#include "fontcache.h"
+
+class GlyphKey
+{
+public:
+	uint ch;
+	QRgb fg;
+	uchar flags;
+
+	bool operator==(const GlyphKey& other) const {
+		return ch == other.ch && fg == other.fg && flags == other.flags;
+	}
+};
+
+inline uint qHash(const GlyphKey& key)
+{
+	return qHash(((quint64)key.fg << 32) | key.ch) ^ key.flags;
+}
+
+/**
+ * GlyphCache keeps pre-rendered character cells in an atlas image
+ *
+ * Glyphs are keyed by codepoint, style (ShellCell::Bold, Italic and
+ * Underline) and foreground color, and are rendered over a transparent
+ * background so they can be blitted over any cell background.
+ *
+ * Glyphs are rendered at the device pixel ratio of the shell, the
+ * slots are cell sized in logical pixels.
+ *
+ * When the atlas is full it is simply emptied.
+ */
+class GlyphCache
+{
+public:
+	GlyphCache();
+
+	bool setFont(const FontCache& fonts, int width, int height, int ascent, qreal ratio=1.0);
+	void draw(QPainter& painter, const QPoint& pos, uint ch, uchar flags, QRgb fg);
+	void clear();
+
+	qint64 hits() const { return m_hits; }
+	qint64 misses() const { return m_misses; }
+
+protected:
+	QRect glyph(uint ch, uchar flags, QRgb fg);
+
+private:
+	static const int AtlasColumns = 64;
+	static const int AtlasRows = 32;
+
+	QFont m_font;
+	QFont m_styles[8];
+	int m_width, m_height, m_ascent;
+	qreal m_ratio;
+
+	QImage m_atlas;
+	QHash<GlyphKey, int> m_slots;
+	qint64 m_hits, m_misses;
+};
+
+#endif
@@ -3,17 +3,22 @@
 #include <QToolBar>
 #include <QMenuBar>
 #include <QEvent>
-
+#include <QSettings>
+#include <QFile>
+#include <QFileInfo>
+#include <QDir>
+
+/*
+ * Only the shell is created here, the tool bar, tab line and menu
+ * bar are filled the first time they are needed - which for many
+ * setups is after the first frame.
+ */
 MainWindow::MainWindow( gui_T* gui, QWidget *parent)
-:QMainWindow(parent), m_keepTabbar(false)
+:QMainWindow(parent), toolbar(0), tabtoolbar(0), tabbar(0), m_keepTabbar(false)
 {
 	setWindowIcon(QIcon(":/icons/vim-qt.png"));
 	setContextMenuPolicy(Qt::PreventContextMenu);
 
-	// Tool bar
-	toolbar = addToolBar("ToolBar");
-	toolbar->setObjectName("toolbar");
-
 	// Vim shell
 	vimshell = new QVimShell(this);
 
@@ -23,16 +28,19 @@ MainWindow::MainWindow( gui_T* gui, QWidget *parent)
 		scrollarea, SLOT(setBackgroundColor(QColor)) );
 
 	setCentralWidget(scrollarea);
+	vimshell->setFocus();
+}
 
-	// TabLine
-	tabtoolbar = addToolBar("tabline");
-	tabtoolbar->setObjectName("tabline");
-
-	connect( tabtoolbar, SIGNAL(orientationChanged(Qt::Orientation)),
-			this, SLOT(updateTabOrientation()) );
-	connect( tabtoolbar, SIGNAL(topLevelChanged(bool)),
-			this, SLOT(updateTabOrientation()));
+/*
+ * The tab line, created on first use
+ */
+TabBar* MainWindow::tabBar()
+{
+	if ( tabbar ) {
+		return tabbar;
+	}
 
+	createToolBars();
 	tabbar = new TabBar(tabtoolbar);
 	tabbar->setTabsClosable(true);
 	tabbar->setExpanding(false);
@@ -55,8 +63,51 @@ MainWindow::MainWindow( gui_T* gui, QWidget *parent)
 	connect( newTab, SIGNAL(triggered()),
 			this, SLOT(openNewTab()));
 
+	TIME_MSG("GUI: tab line created");
+	return tabbar;
+}
 
-	vimshell->setFocus();
+/*
+ * The empty tool bar and tab line, hidden until Vim asks for
+ * them. They must exist before restoreState() to get their saved
+ * position, their contents are only added when first used.
+ */
+void MainWindow::createToolBars()
+{
+	if ( !toolbar ) {
+		toolbar = new QToolBar("ToolBar", this);
+		toolbar->setObjectName("toolbar");
+		toolbar->hide();
+		addToolBar(toolbar);
+	}
+
+	if ( !tabtoolbar ) {
+		tabtoolbar = new QToolBar("tabline", this);
+		tabtoolbar->setObjectName("tabline");
+		tabtoolbar->hide();
+		addToolBar(tabtoolbar);
+
+		connect( tabtoolbar, SIGNAL(orientationChanged(Qt::Orientation)),
+				this, SLOT(updateTabOrientation()) );
+		connect( tabtoolbar, SIGNAL(topLevelChanged(bool)),
+				this, SLOT(updateTabOrientation()));
+	}
+}
+
+/*
+ * Load the qVim style sheet from the settings directory, this is
+ * left until after the first frame
+ */
+void MainWindow::loadStyleSheet()
+{
+	QSettings ini(QSettings::IniFormat, QSettings::UserScope, "Vim", "qVim");
+	QFile styleFile( QFileInfo(ini.fileName()).absoluteDir().absoluteFilePath("qVim.style") );
+
+	if ( styleFile.open(QIODevice::ReadOnly) ) {
+		setStyleSheet( styleFile.readAll() );
+		styleFile.close();
+	}
+	TIME_MSG("GUI: style sheet loaded");
 }
 
 void MainWindow::tabMoved(int from, int to)
@@ -100,9 +151,16 @@ void MainWindow::updateTabOrientation()
 	}
 }
 
+/*
+ * The bars are created before the state is restored, and hidden
+ * again afterwards until Vim asks for them
+ */
 bool MainWindow::restoreState(const QByteArray& state, int version)
 {
+	createToolBars();
 	bool ret = QMainWindow::restoreState(state, version);
+	toolbar->hide();
+	tabtoolbar->hide();
 	if ( keepTabbar() ) {
 		showTabline(true);
 	}
@@ -110,13 +168,30 @@ bool MainWindow::restoreState(const QByteArray& state, int version)
 	return ret;
 }
 
+/*
+ * Bars that were never used still have to be saved, or their
+ * position would be lost
+ */
+QByteArray MainWindow::saveState(int version)
+{
+	createToolBars();
+	return QMainWindow::saveState(version);
+}
+
 QVimShell* MainWindow::vimShell()
 {
 	return this->vimshell;
 }
 
-QToolBar* MainWindow::toolBar() const
+/*
+ * The tool bar, created on first use
+ */
+QToolBar* MainWindow::toolBar()
 {
+	if ( !toolbar ) {
+		createToolBars();
+		TIME_MSG("GUI: tool bar created");
+	}
 	return toolbar;
 }
 
@@ -148,35 +223,41 @@ void MainWindow::showTabline(bool show)
 		removeTabs(1);
 	}
 
-	if ( keepTabbar() ) {
+	if ( keepTabbar() || show ) {
+		tabBar();
 		tabtoolbar->setVisible(true);
-	} else {
-		tabtoolbar->setVisible(show);
+	} else if ( tabtoolbar ) {
+		tabtoolbar->setVisible(false);
 	}
 }
 
 void MainWindow::showToolbar(bool show)
 {
-	toolbar->setVisible(show);
+	if ( show || toolbar ) {
+		toolBar()->setVisible(show);
+	}
 }
 
 void MainWindow::showMenu(bool show)
 {
-	QMainWindow::menuBar()->setVisible(show);
+	if ( show || menuWidget() ) {
+		QMainWindow::menuBar()->setVisible(show);
+	}
 }
 
 bool MainWindow::tablineVisible()
 {
-	return tabtoolbar->isVisible();
+	return tabtoolbar && tabtoolbar->isVisible();
 }
 
 void MainWindow::setCurrentTab(int idx)
 {
-	tabbar->setCurrentIndex(idx);
+	tabBar()->setCurrentIndex(idx);
 }
 
 void MainWindow::setTab( int idx, const QString& label)
 {
+	tabBar();
 	while ( tabbar->count() <= idx ) {
 		tabbar->addTab("[No name]");
 	}
@@ -187,12 +268,44 @@ void MainWindow::setTab( int idx, const QString& label)
 
 void MainWindow::removeTabs(int idx)
 {
-	int i;
-	for ( i=idx; i<tabbar->count(); i++) {
-		tabbar->removeTab(i);
+	if ( !tabbar ) {
+		return;
+	}
+	while ( tabbar->count() > idx ) {
+		tabbar->removeTab(tabbar->count()-1);
 	}
 }
 
+/*
+ * Update the tabline to show the given labels
+ *
+ * Only the tabs whose label changed are touched, and the tab
+ * bar is repainted once at the end. The tab bar is only following
+ * Vim here, so no signals are sent back.
+ */
+void MainWindow::setTabs(const QStringList& labels, int current)
+{
+	tabBar();
+	bool blocked = tabbar->blockSignals(true);
+	tabbar->setUpdatesEnabled(false);
+
+	for (int i=0; i<labels.size(); i++) {
+		if ( i >= tabbar->count() ) {
+			tabbar->addTab(labels.at(i));
+		} else if ( tabbar->tabText(i) != labels.at(i) ) {
+			tabbar->setTabText(i, labels.at(i));
+		}
+	}
+	removeTabs(labels.size());
+
+	if ( tabbar->currentIndex() != current ) {
+		tabbar->setCurrentIndex(current);
+	}
+
+	tabbar->setUpdatesEnabled(true);
+	tabbar->blockSignals(blocked);
+}
+
 void MainWindow::switchTab(int idx)
 {
 	vimshell->switchTab(idx+1);
@@ -217,6 +330,12 @@ void MainWindow::openNewTab()
 void MainWindow::setKeepTabbar(bool keep)
 {
 	m_keepTabbar = keep;
+
+	// The style sheet is loaded late, the tab line may
+	// have been hidden already
+	if ( keep ) {
+		showTabline(true);
+	}
 }
 
 bool MainWindow::keepTabbar()
@@ -2,6 +2,7 @@
 #define __GUI_QT_MAINWINDOW__
 
 #include <QMainWindow>
+#include <QStringList>
 #include "qvimshell.h"
 #include "tabbar.h"
 #include "scrollarea.h"
@@ -17,10 +18,12 @@ public:
 
 	bool tablineVisible();
 
-	QToolBar* toolBar() const;
+	QToolBar* toolBar();
+	TabBar* tabBar();
 	bool keepTabbar();
 
 	bool restoreState(const QByteArray& state, int version=0);
+	QByteArray saveState(int version=0);
 
 public slots:
 	void showTabline(bool show);
@@ -29,12 +32,15 @@ public slots:
 	void setCurrentTab(int idx);
 	void setTab( int, const QString& );
 	void removeTabs(int);
+	void setTabs(const QStringList& labels, int current);
 	void switchTab(int idx);
 	void closeTab(int idx);
 	void setKeepTabbar(bool);
 	void openNewTab();
+	void loadStyleSheet();
 
 protected:
+	void createToolBars();
 	virtual void closeEvent( QCloseEvent *);
 	virtual void changeEvent( QEvent *ev );
 
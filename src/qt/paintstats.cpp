@@ -0,0 +1,102 @@
+#include "paintstats.h"
+
+#include <QStringList>
+
+Histogram::Histogram(qint64 base)
+:m_base(base)
+{
+	reset();
+}
+
+void Histogram::reset()
+{
+	m_count = m_total = m_max = 0;
+	for (int i=0; i<Buckets; i++) {
+		m_buckets[i] = 0;
+	}
+}
+
+/**
+ * Upper bound (exclusive) of bucket i, -1 for the last one
+ */
+qint64 Histogram::limit(int i) const
+{
+	if ( i >= Buckets-1 ) {
+		return -1;
+	}
+	return m_base << i;
+}
+
+void Histogram::add(qint64 value)
+{
+	int i = 0;
+	while ( i < Buckets-1 && value >= limit(i) ) {
+		i++;
+	}
+	m_buckets[i]++;
+	m_count++;
+	m_total += value;
+	m_max = qMax(m_max, value);
+}
+
+/**
+ * One line summary, e.g. "count 10 avg 5 max 9 | <8:3 <16:7"
+ */
+QString Histogram::toString() const
+{
+	QStringList buckets;
+	for (int i=0; i<Buckets; i++) {
+		if ( m_buckets[i] == 0 ) {
+			continue;
+		}
+		QString bound = (limit(i) == -1) ? QString(">=%1").arg(limit(i-1))
+						: QString("<%1").arg(limit(i));
+		buckets.append(QString("%1:%2").arg(bound).arg(m_buckets[i]));
+	}
+
+	return QString("count %1 avg %2 max %3 | %4")
+		.arg(m_count)
+		.arg(m_count ? m_total/m_count : 0)
+		.arg(m_max)
+		.arg(buckets.join(" "));
+}
+
+PaintStats::PaintStats()
+:m_frameTime(64), m_cellsPerFrame(16), m_inputLatency(1024)
+{
+	reset();
+}
+
+void PaintStats::reset()
+{
+	m_frames = m_rows = m_cells = 0;
+	m_frameTime.reset();
+	m_cellsPerFrame.reset();
+	m_inputLatency.reset();
+	m_inputClock.invalidate();
+}
+
+/**
+ * Start measuring input latency, unless an earlier input
+ * is still waiting for its frame
+ */
+void PaintStats::inputReceived()
+{
+	if ( !m_inputClock.isValid() ) {
+		m_inputClock.start();
+	}
+}
+
+void PaintStats::framePainted(qint64 usec, int rows, int cells)
+{
+	m_frames++;
+	m_rows += rows;
+	m_cells += cells;
+	m_frameTime.add(usec);
+	m_cellsPerFrame.add(cells);
+
+	if ( m_inputClock.isValid() ) {
+		m_inputLatency.add(m_inputClock.nsecsElapsed()/1000);
+		m_inputClock.invalidate();
+	}
+}
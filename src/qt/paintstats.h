@@ -0,0 +1,68 @@
+#ifndef __VIM_QT_PAINTSTATS__
+#define __VIM_QT_PAINTSTATS__
+
+#include <QElapsedTimer>
+#include <QString>
+
+/**
+ * A histogram with power of two buckets, bucket i counts the
+ * samples below base*2^i and the last bucket counts the rest
+ */
+class Histogram
+{
+public:
+	static const int Buckets = 12;
+
+	Histogram(qint64 base=1);
+	void add(qint64 value);
+	void reset();
+
+	qint64 count() const { return m_count; }
+	qint64 total() const { return m_total; }
+	qint64 max() const { return m_max; }
+	qint64 bucket(int i) const { return m_buckets[i]; }
+	qint64 limit(int i) const;
+
+	QString toString() const;
+
+private:
+	qint64 m_base;
+	qint64 m_count, m_total, m_max;
+	qint64 m_buckets[Buckets];
+};
+
+/**
+ * PaintStats collects counters for the shell paint pipeline
+ *
+ * - frame time, the time spent in each paint event (usec)
+ * - cells per frame, the number of grid cells rasterized
+ * - input latency, from a key press until the end of the
+ *   first paint event after it (usec)
+ */
+class PaintStats
+{
+public:
+	PaintStats();
+	void reset();
+
+	void inputReceived();
+	void framePainted(qint64 usec, int rows, int cells);
+
+	qint64 frames() const { return m_frames; }
+	qint64 rows() const { return m_rows; }
+	qint64 cells() const { return m_cells; }
+
+	const Histogram& frameTime() const { return m_frameTime; }
+	const Histogram& cellsPerFrame() const { return m_cellsPerFrame; }
+	const Histogram& inputLatency() const { return m_inputLatency; }
+
+private:
+	qint64 m_frames, m_rows, m_cells;
+	Histogram m_frameTime;
+	Histogram m_cellsPerFrame;
+	Histogram m_inputLatency;
+
+	QElapsedTimer m_inputClock;
+};
+
+#endif
@@ -6,17 +6,29 @@
 #include <QFile>
 #include <QTimer>
 #include <QMimeData>
+#include <QThread>
+#include <QRunnable>
+#include <QFontDatabase>
+#include <algorithm>
+#include <string.h>
+#if QT_VERSION >= 0x050000
+# include <QScreen>
+# include <QWindow>
+#endif
 
 extern "C" {
 #include "proto/gui.pro"
 }
 
 #include "colortable.h"
+#include "drawtrace.h"
+#include "signicon.h"
 
 QVimShell::QVimShell(QWidget *parent)
-:QWidget(parent), m_encoding_utf8(true),
-	m_lastClickEvent(-1), m_tooltip(0), m_slowStringDrawing(false),
-	m_mouseHidden(false)
+:QWidget(parent), m_encoding_utf8(true), m_wideFontSelected(false),
+	m_pixelRatio(1.0), m_cursorRow(-1), m_cursorCol1(0), m_cursorCol2(0),
+	m_cursorColor(0), m_cursorHollow(false), m_lastClickEvent(-1), m_tooltip(0),
+	m_slowStringDrawing(false), m_mouseHidden(false), m_trace(0), m_maxFrameRate(0)
 {
 	setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Expanding);
 
@@ -48,16 +60,28 @@ QVimShell::QVimShell(QWidget *parent)
 	setAcceptDrops(true);
 	setMouseTracking(true);
 
-	PaintOperation op;
-	op.type = CLEARALL;
-	op.color = background();
-	queuePaintOp(op);
+	// Frame scheduling
+	m_frameTimer = new QTimer(this);
+	m_frameTimer->setSingleShot(true);
+	connect(m_frameTimer, SIGNAL(timeout()), this, SLOT(presentFrame()));
+	m_frameClock.start();
+
+	// Resize throttling
+	m_resizeTimer = new QTimer(this);
+	m_resizeTimer->setSingleShot(true);
+	connect(m_resizeTimer, SIGNAL(timeout()), this, SLOT(commitResize()));
+
+	m_rasterPool = new QThreadPool(this);
+	setRasterThreads(QThread::idealThreadCount());
 }
 
 void QVimShell::setBackground(const QColor color)
 {
 	m_background = color;
 	emit backgroundColorChanged(m_background);
+
+	// The area outside the grid is painted with the background
+	update();
 }
 
 void QVimShell::switchTab(int idx)
@@ -76,32 +100,51 @@ QColor QVimShell::background()
 	return m_background;
 }
 
+/*
+ * While the shell is being resized the last frame is stretched over
+ * it, Vim only gets the new size once the resizing settles. The first
+ * resize goes straight through.
+ */
 void QVimShell::resizeEvent(QResizeEvent *ev)
 {
-	PaintOperation op;
-	op.type = FILLRECT;
-	op.color = background();
-
-	int dWidth = ev->size().width() - ev->oldSize().width();
-	if (dWidth > 0)
-	{
-		op.rect = QRect(ev->oldSize().width(), 0, dWidth, ev->size().height());
-		queuePaintOp(op);
+	m_resizeSize = ev->size();
+	if ( !m_committedSize.isValid() || !isVisible() ) {
+		commitResize();
+		return;
 	}
 
-	int dHeight = ev->size().height() - ev->oldSize().height();
-	if (dHeight > 0)
-	{
-		op.rect = QRect(0, ev->oldSize().height(), ev->size().width(), dHeight);
-		queuePaintOp(op);
-	}
+	update();
+	m_resizeTimer->start(ResizeSettleFrames*frameInterval());
+}
+
+void QVimShell::commitResize()
+{
+	m_resizeTimer->stop();
+	m_committedSize = m_resizeSize;
 
 	//
 	// Vim might trigger another resize, postpone the call
 	// to guiResizeShell - otherwise we might be called
 	// recursivelly and crash
 	//
-	postGuiResizeShell(ev->size().width(), ev->size().height());
+	postGuiResizeShell(m_resizeSize.width(), m_resizeSize.height());
+	update();
+}
+
+/*
+ * Stretch the backing image over the shell, as it was laid out
+ * for the size Vim knows about
+ */
+void QVimShell::paintPlaceholder(QPainter& painter)
+{
+	qreal sx = (qreal)width()/qMax(m_committedSize.width(), 1);
+	qreal sy = (qreal)height()/qMax(m_committedSize.height(), 1);
+	QRect target(0, 0, qRound(m_backingSize.width()*sx), qRound(m_backingSize.height()*sy));
+
+	painter.drawImage(target, m_backing);
+	foreach(const QRect& r, QRegion(rect()).subtracted(target).rects()) {
+		painter.fillRect(r, background());
+	}
 }
 
 int_u QVimShell::vimKeyboardModifiers(Qt::KeyboardModifiers mod)
@@ -139,9 +182,25 @@ int_u QVimShell::vimMouseModifiers(Qt::KeyboardModifiers mod)
 }
 
 
+/*
+ * Index of a Qt key in special_keys, or -1 - the table is
+ * hashed the first time it is used
+ */
+static int specialKeyIndex(int key)
+{
+	static QHash<int, int> index;
+	if ( index.isEmpty() ) {
+		for (int i = 0; special_keys[i].key_sym != 0; ++i) {
+			index.insert(special_keys[i].key_sym, i);
+		}
+	}
+	return index.value(key, -1);
+}
 
 void QVimShell::keyPressEvent ( QKeyEvent *ev)
 {
+	m_stats.inputReceived();
+
 	// mousehide - conceal mouse pointer when typing
 	if (p_mh && !m_mouseHidden ) {
 		QApplication::setOverrideCursor(Qt::BlankCursor);
@@ -150,28 +209,27 @@ void QVimShell::keyPressEvent ( QKeyEvent *ev)
 
 	int key_char = 0;
 	int vimModifiers = vimKeyboardModifiers(QApplication::keyboardModifiers());
-	if ( !ev->text().isEmpty() ) {
-		key_char = ev->text()[0].unicode(); // key compression is off
+	const QString text = ev->text();
+	if ( !text.isEmpty() ) {
+		key_char = text[0].unicode(); // key compression is off
+		if ( text.size() > 1 && text[0].isHighSurrogate() && text[1].isLowSurrogate() ) {
+			key_char = QChar::surrogateToUcs4(text[0], text[1]);
+		}
 	}
 
 	/* Find the special key */
-	int i;
 	bool isSpecial = false;
-	for (i = 0; special_keys[i].key_sym != 0; ++i) {
-		if (special_keys[i].key_sym == ev->key())
-		{
-
-			if (special_keys[i].code1 == NUL) {
-				key_char = special_keys[i].code0;
-			} else {
-				key_char = TO_SPECIAL(special_keys[i].code0, special_keys[i].code1);
-				key_char = simplify_key(key_char,
-					(int *)&vimModifiers);
-			}
-			if (ev->key() != Qt::Key_Backtab) {
-				isSpecial = TRUE;
-			}
-			break;
+	int i = specialKeyIndex(ev->key());
+	if ( i != -1 ) {
+		if (special_keys[i].code1 == NUL) {
+			key_char = special_keys[i].code0;
+		} else {
+			key_char = TO_SPECIAL(special_keys[i].code0, special_keys[i].code1);
+			key_char = simplify_key(key_char,
+				(int *)&vimModifiers);
+		}
+		if (ev->key() != Qt::Key_Backtab) {
+			isSpecial = TRUE;
 		}
 	}
 
@@ -217,22 +275,23 @@ void QVimShell::keyPressEvent ( QKeyEvent *ev)
 		}
 	}
 
-	char_u result[3];
+	// Keys are queued, Vim gets them once the event loop is
+	// done with the keys that are pending
+	char_u result[MB_MAXBYTES];
 	if (vimModifiers) {
 		result[0] = CSI;
 		result[1] = KS_MODIFIER;
 		result[2] = vimModifiers;
-		add_to_input_buf(result, 3);
+		queueInput(result, 3);
 	}
 
 	if (isSpecial && IS_SPECIAL(key_char)) {
 		result[0] = CSI;
 		result[1] = K_SECOND(key_char);
 		result[2] = K_THIRD(key_char);
-		add_to_input_buf(result, 3);
+		queueInput(result, 3);
 	} else {
-		QByteArray utf8 = QString(QChar(key_char)).toUtf8();
-		add_to_input_buf_csi( (char_u *) utf8.data(), utf8.size());
+		queueInput(result, utf_char2bytes(key_char, result), true);
 	}
 }
 
@@ -297,139 +356,458 @@ QFont QVimShell::fixPainterFont( const QFont& pfont )
 }
 
 /*
- * Slow text painting strategy
+ * Text style comparison for painting runs of cells,
+ * signs are always painted on their own
+ */
+static bool sameTextStyle(const ShellCell& a, const ShellCell& b)
+{
+	if ( (a.flags | b.flags) & ShellCell::Sign ) {
+		return false;
+	}
+	if ( (a.flags & ~ShellCell::Inverted) != (b.flags & ~ShellCell::Inverted) ) {
+		return false;
+	}
+	if ( (a.flags & ShellCell::Undercurl) && a.sp != b.sp ) {
+		return false;
+	}
+	return a.foreground() == b.foreground();
+}
+
+/*
+ * Move the pixels inside rect by dy pixel rows, down if dy is
+ * positive. Pixels moved out of rect are lost, the rows left behind
+ * keep their old contents.
+ */
+static void scrollImage(QImage& img, const QRect& rect, int dy)
+{
+	if ( qAbs(dy) >= rect.height() ) {
+		return;
+	}
+
+	const int offset = rect.left()*4;
+	const int len = rect.width()*4;
+	if ( dy > 0 ) {
+		for (int y=rect.bottom(); y>=rect.top()+dy; y--) {
+			memmove(img.scanLine(y) + offset, img.scanLine(y-dy) + offset, len);
+		}
+	} else if ( dy < 0 ) {
+		for (int y=rect.top(); y<=rect.bottom()+dy; y++) {
+			memmove(img.scanLine(y) + offset, img.scanLine(y-dy) + offset, len);
+		}
+	}
+}
+
+/*
+ * Images are rasterized at the device pixel ratio of the screen, the
+ * painter still works in logical pixels
+ */
+static void setImageRatio(QImage& img, qreal ratio)
+{
+#if QT_VERSION >= 0x050000
+	img.setDevicePixelRatio(ratio);
+#else
+	Q_UNUSED(img);
+	Q_UNUSED(ratio);
+#endif
+}
+
+static QRect toDevice(const QRect& rect, qreal ratio)
+{
+	int left = qRound(rect.left()*ratio);
+	int top = qRound(rect.top()*ratio);
+	return QRect(left, top, qRound((rect.right()+1)*ratio) - left,
+			qRound((rect.bottom()+1)*ratio) - top);
+}
+
+/*
+ * The device pixel ratio of the screen the shell is on
+ */
+qreal QVimShell::pixelRatio() const
+{
+#if QT_VERSION >= 0x050600
+	return devicePixelRatioF();
+#elif QT_VERSION >= 0x050000
+	return devicePixelRatio();
+#else
+	return 1.0;
+#endif
+}
+
+/*
+ * Paint the cells col1..col2 of a grid row
  *
- * - Paints one character at a time
- * - Looks perfect in any condition
- * - Takes a looong time
- * - FIXME: add support for proper undercurl
- */
-void QVimShell::drawStringSlow( const PaintOperation& op, QPainter &painter )
-{
-	QFont f = op.font;
-	painter.setFont(f);
-	painter.setPen( op.color );
-
-	QRect rect = op.rect;
-	foreach(QChar c, op.str) {
-		if ( VimWrapper::charCellWidth(c) == 1 ) {
-			rect.setWidth(VimWrapper::charWidth());
-		} else if (VimWrapper::charCellWidth(c) == 2) {
-			rect.setWidth(2*VimWrapper::charWidth());
-		} else {
-			qDebug() << __func__ << "invalid lenght" << c << VimWrapper::charCellWidth(c);
+ * Backgrounds are filled first, then the partial cursor and
+ * finally the text, this is the same order Vim draws them.
+ */
+void QVimShell::paintRow(QPainter& painter, GlyphCache& glyphs, int row, int col1, int col2)
+{
+	const int w = VimWrapper::charWidth();
+	const int h = VimWrapper::charHeight();
+
+	// Never split a double width character or a sign
+	if ( col1 > 0 && (m_grid.cell(row, col1).ch == 0 ||
+			(m_grid.cell(row, col1-1).flags & ShellCell::Sign)) ) {
+		col1--;
+	}
+	if ( col2+1 < m_grid.columns() && m_grid.cell(row, col2+1).ch == 0 ) {
+		col2++;
+	}
+
+	int col = col1;
+	while ( col <= col2 ) {
+		QRgb bg = m_grid.cell(row, col).background();
+		int end = col+1;
+		while ( end <= col2 && m_grid.cell(row, end).background() == bg ) {
+			end++;
+		}
+		painter.fillRect(col*w, row*h, (end-col)*w, h, QColor(bg));
+		col = end;
+	}
+
+	if ( row == m_cursorRow && !m_cursorHollow ) {
+		painter.fillRect(m_cursorRect, QColor(m_cursorColor));
+	}
+
+	col = col1;
+	while ( col <= col2 ) {
+		const ShellCell& first = m_grid.cell(row, col);
+		int end = col+1;
+		while ( end <= col2 && sameTextStyle(first, m_grid.cell(row, end)) ) {
+			end++;
+		}
+		paintRun(painter, glyphs, row, col, end-1);
+		col = end;
+	}
+
+	if ( row == m_cursorRow && m_cursorHollow ) {
+		painter.setPen(QColor(m_cursorColor));
+		painter.setBrush(Qt::NoBrush);
+		painter.drawRect(m_cursorRect);
+	}
+}
+
+/*
+ * Paint the text of the cells col1..col2 in a row, all cells
+ * share the same text style. Sign cells are left to paintSigns().
+ *
+ * Cells are blitted from the glyph cache, double width and composing
+ * characters are shaped by QPainter::drawText. If the font is not a
+ * proper monospace font (see setSlowStringDrawing()) every cell is
+ * shaped on its own.
+ *
+ * FIXME: add support for proper undercurl
+ */
+void QVimShell::paintRun(QPainter& painter, GlyphCache& glyphs, int row, int col1, int col2)
+{
+	const int w = VimWrapper::charWidth();
+	const int h = VimWrapper::charHeight();
+	const ShellCell& style = m_grid.cell(row, col1);
+	QRect rect(col1*w, row*h, (col2-col1+1)*w, h);
+
+	if ( style.flags & ShellCell::Sign ) {
+		return;
+	}
+
+	bool undercurl = style.flags & ShellCell::Undercurl;
+	uchar glyphFlags = style.flags & (ShellCell::Bold | ShellCell::Italic | ShellCell::Underline);
+	// Disable underline if undercurl is in place
+	if ( undercurl ) {
+		glyphFlags &= ~ShellCell::Underline;
+	}
+
+	QRgb fg = style.foreground();
+	bool shaping = false;
+	for (int col=col1; col<=col2; col++) {
+		const ShellCell& cell = m_grid.cell(row, col);
+		if ( cell.ch == 0 ) {
+			continue;
+		}
+
+		bool composed = m_grid.isComposed(row, col);
+		bool wide = col+1 < m_grid.columns() && m_grid.cell(row, col+1).ch == 0;
+		if ( cell.ch == ' ' && !composed && !(glyphFlags & ShellCell::Underline) ) {
+			continue;
+		}
+
+		if ( !composed && !wide && !m_slowStringDrawing
+				&& !(style.flags & ShellCell::WideFont) ) {
+			glyphs.draw(painter, QPoint(col*w, rect.top()), cell.ch, glyphFlags, fg);
+			continue;
+		}
+
+		if ( !shaping ) {
+			painter.setClipRect(rect);
+			painter.setFont(m_fonts.font(glyphFlags,
+					style.flags & ShellCell::WideFont));
+			painter.setPen(QColor(fg));
+			shaping = true;
+		}
+		painter.drawText(QPoint(col*w, rect.top() + gui.char_ascent),
+				m_grid.text(row, col));
+	}
+
+	if ( undercurl ) {
+		QPoint start(rect.left(), rect.top() + gui.char_ascent + 1 + gui.char_ul_pos);
+		QPoint end(rect.right(), start.y());
+
+		QPen pen(QColor(style.sp), 1, Qt::DashDotDotLine);
+		painter.setClipRect(rect);
+		painter.setPen(pen);
+		painter.drawLine(QLine(start, end));
+		shaping = true;
+	}
+
+	if ( shaping ) {
+		painter.setClipping(false);
+	}
+}
+
+/*
+ * Paint the signs in the cells col1..col2 of a row. Signs are
+ * pixmaps, they can only be painted in the GUI thread.
+ */
+void QVimShell::paintSigns(QPainter& painter, int row, int col1, int col2)
+{
+	const int w = VimWrapper::charWidth();
+	const int h = VimWrapper::charHeight();
+
+	const qreal ratio = m_pixelRatio;
+
+	// A sign spans two cells
+	for (int col=qMax(col1-1, 0); col<=col2; col++) {
+		const ShellCell& cell = m_grid.cell(row, col);
+		if ( !(cell.flags & ShellCell::Sign) ) {
 			continue;
 		}
 
-		QPoint pos = op.pos;
-		pos.setX(rect.left());
-		painter.drawText(pos, c);
-		rect.moveTo( rect.x() + rect.width(), rect.y() );
+		SignIcon *icon = (SignIcon *)sign_get_image(cell.ch);
+		if ( icon ) {
+			painter.drawPixmap(QPoint(col*w, row*h),
+					icon->pixmap(QSize(2*w, h), ratio));
+		}
 	}
 }
 
-/**
- * Draw a string into the canvas
+/*
+ * Rasterize the spans first..last into a band of the backing
+ * image, the band starts at logical pixel row top
+ */
+void QVimShell::rasterizeBand(QImage band, qreal top, GlyphCache& glyphs,
+			const QVector<RowSpan>& spans, int first, int last)
+{
+	QPainter painter(&band);
+	painter.translate(0, -top);
+	for (int i=first; i<=last; i++) {
+		const RowSpan& span = spans.at(i);
+		paintRow(painter, glyphs, span.row, span.left, span.right);
+	}
+}
+
+class RowBandJob: public QRunnable
+{
+public:
+	RowBandJob(QVimShell *shell, const QImage& band, qreal top, GlyphCache& glyphs,
+			const QVector<RowSpan>& spans, int first, int last)
+	:m_shell(shell), m_band(band), m_top(top), m_glyphs(glyphs),
+		m_spans(spans), m_first(first), m_last(last)
+	{
+	}
+
+	void run()
+	{
+		m_shell->rasterizeBand(m_band, m_top, m_glyphs, m_spans, m_first, m_last);
+	}
+
+private:
+	QVimShell *m_shell;
+	QImage m_band;
+	qreal m_top;
+	GlyphCache& m_glyphs;
+	const QVector<RowSpan>& m_spans;
+	int m_first, m_last;
+};
+
+static bool rowLessThan(const RowSpan& a, const RowSpan& b)
+{
+	return a.row < b.row;
+}
+
+/*
+ * Rasterize the damaged spans into the backing image, returns
+ * the number of cells painted.
  *
+ * Small redraws are painted right here. Large ones are split in
+ * bands of whole rows with about the same number of cells, worker
+ * threads paint each band into the rows of the backing image it
+ * covers. The grid cannot change until all bands are done.
  */
-void QVimShell::drawString( const PaintOperation& op, QPainter &painter)
+int QVimShell::paintSpans(const QVector<RowSpan>& spans)
 {
-	painter.setPen( op.color );
-	painter.setFont(op.font);
-	painter.drawText( op.pos, op.str);
+	int cells = 0;
+	foreach(const RowSpan& span, spans) {
+		cells += span.right - span.left + 1;
+	}
+
+	const int bands = qMin(m_bandGlyphs.size(), cells/ParallelCells);
+	if ( bands < 2 ) {
+		QPainter painter(&m_backing);
+		foreach(const RowSpan& span, spans) {
+			paintRow(painter, m_glyphs, span.row, span.left, span.right);
+			paintSigns(painter, span.row, span.left, span.right);
+		}
+		return cells;
+	}
+
+	QVector<RowSpan> sorted = spans;
+	std::stable_sort(sorted.begin(), sorted.end(), rowLessThan);
+
+	const int h = VimWrapper::charHeight();
+	const int bandCells = (cells + bands - 1)/bands;
+	int band = 0, first = 0, count = 0;
+	for (int i=0; i<sorted.size(); i++) {
+		count += sorted.at(i).right - sorted.at(i).left + 1;
+
+		// Bands end on a row boundary, the same row
+		// is never painted by two threads
+		bool last = (i+1 == sorted.size());
+		if ( !last && (count < bandCells || sorted.at(i+1).row == sorted.at(i).row) ) {
+			continue;
+		}
+
+		// Bands are whole device pixel rows
+		int top = qRound(sorted.at(first).row*h*m_pixelRatio);
+		int height = qRound((sorted.at(i).row+1)*h*m_pixelRatio) - top;
+		QImage image(m_backing.scanLine(top), m_backing.width(), height,
+				m_backing.bytesPerLine(), m_backing.format());
+		setImageRatio(image, m_pixelRatio);
+		m_rasterPool->start(new RowBandJob(this, image, top/m_pixelRatio,
+				m_bandGlyphs[band], sorted, first, i));
+
+		band++;
+		first = i+1;
+		count = 0;
+	}
+	m_rasterPool->waitForDone();
+
+	QPainter painter(&m_backing);
+	foreach(const RowSpan& span, sorted) {
+		paintSigns(painter, span.row, span.left, span.right);
+	}
+	return cells;
 }
 
+/*
+ * Make sure the backing image matches the grid size and the device
+ * pixel ratio, a new image has to be rasterized from scratch.
+ *
+ * Cell metrics are integers in logical pixels, the backing image
+ * and the glyphs are rasterized at the device pixel ratio.
+ */
+void QVimShell::syncBacking()
+{
+	const int w = VimWrapper::charWidth();
+	const int h = VimWrapper::charHeight();
+	if ( w <= 0 || h <= 0 ) {
+		return;
+	}
+
+	const qreal ratio = pixelRatio();
+	bool fontChanged = m_glyphs.setFont(m_fonts, w, h, gui.char_ascent, ratio);
+	for (int i=0; i<m_bandGlyphs.size(); i++) {
+		m_bandGlyphs[i].setFont(m_fonts, w, h, gui.char_ascent, ratio);
+	}
+
+	QSize size(m_grid.columns()*w, m_grid.rows()*h);
+	if ( m_backingSize != size || m_pixelRatio != ratio ) {
+		m_backing = QImage(toDevice(QRect(QPoint(0, 0), size), ratio).size(),
+				QImage::Format_RGB32);
+		setImageRatio(m_backing, ratio);
+		m_backing.fill(background().rgb());
+		m_backingSize = size;
+		m_pixelRatio = ratio;
+		fontChanged = true;
+	}
+
+	if ( fontChanged ) {
+		m_grid.markDirty(0, 0, m_grid.rows()-1, m_grid.columns()-1);
+		scheduleFrame();
+	}
+}
+
+/*
+ * Rasterize the damaged grid rows within the paint event region into
+ * the backing image and blit it to the widget. Rows that are painted
+ * in full are marked clean.
+ */
 void QVimShell::paintEvent ( QPaintEvent *ev )
 {
-	m_painter.begin(this);
-	while ( !paintOps.isEmpty() ) {
-		m_painter.save();
-
-		PaintOperation op = paintOps.dequeue();
-		switch( op.type ) {
-		case CLEARALL:
-			m_painter.fillRect(this->rect(), op.color);
-			break;
-		case FILLRECT:
-			m_painter.fillRect(op.rect, op.color);
-			break;
-		case DRAWRECT:
-			m_painter.setPen(op.color);
-			m_painter.drawRect(op.rect);
-			break;
-		case DRAWSTRING:
-			m_painter.setClipRect(op.rect);
-
-			// Disable underline if undercurl is in place
-			if (op.undercurl && op.font.underline()) {
-				op.font.setUnderline(false);
-			}
+	QElapsedTimer paintTime;
+	paintTime.start();
+	int paintedRows = 0, paintedCells = 0;
 
-			if ( m_slowStringDrawing ) {
-				drawStringSlow(op, m_painter);
-			} else if ( op.str.length() != VimWrapper::stringCellWidth(op.str) ) {
-				drawStringSlow(op, m_painter);
-			} else {
-				drawString(op, m_painter);
+	const int w = VimWrapper::charWidth();
+	const int h = VimWrapper::charHeight();
+
+	// The grid still has the old size, nothing to rasterize
+	if ( m_resizeTimer->isActive() && !m_backing.isNull() ) {
+		QPainter painter(this);
+		paintPlaceholder(painter);
+		return;
+	}
+
+	QRect gridRect;
+	if ( w > 0 && h > 0 ) {
+		syncBacking();
+		gridRect = QRect(QPoint(0, 0), m_backingSize);
+	}
+
+	if ( !gridRect.isEmpty() ) {
+		QVector<RowSpan> spans;
+		foreach(const QRect& r, ev->region().rects()) {
+			QRect rect = r.intersected(gridRect);
+			if ( rect.isEmpty() ) {
+				continue;
 			}
 
-			// Draw undercurl
-			// FIXME: we are doing it wrong - the underlinePos needs
-			// to be stored someplace else
-			if (op.undercurl) {
-				QPoint start(op.rect.bottomLeft());
-				start.setY(op.pos.y() + 1 + gui.char_ul_pos );
-				QPoint end(start);
-				end.setX(op.rect.right());
-
-				QPen pen(op.curlcolor, 1, Qt::DashDotDotLine);
-				m_painter.setPen(pen);
-				m_painter.drawLine(QLine(start, end));
+			int col1 = rect.left()/w;
+			int col2 = rect.right()/w;
+			for (int row=rect.top()/h; row<=rect.bottom()/h; row++) {
+				if ( !m_grid.isDirty(row) ) {
+					continue;
+				}
+
+				int left = qMax(col1, m_grid.dirtyLeft(row));
+				int right = qMin(col2, m_grid.dirtyRight(row));
+				if ( left <= right ) {
+					RowSpan span = {row, left, right};
+					spans.append(span);
+				}
+				if ( col1 <= m_grid.dirtyLeft(row)
+						&& m_grid.dirtyRight(row) <= col2 ) {
+					m_grid.setClean(row);
+				}
 			}
+		}
 
-			break;
-		case DRAWSIGN:
-			m_painter.drawPixmap( op.pos, op.sign);
-			break;
-		case INVERTRECT:
-			m_painter.setCompositionMode( QPainter::RasterOp_SourceXorDestination );
-			m_painter.fillRect( op.rect, Qt::color0);
-			m_painter.setCompositionMode( QPainter::CompositionMode_SourceOver );
-			break;
-		case SCROLLRECT:
-			m_painter.restore();
-			m_painter.end();
+		paintedRows = spans.size();
+		paintedCells = paintSpans(spans);
+	}
 
-#if QT_VERSION >= 0x050000
-			// From #56, in Qt5 scrolling does not work inside
-			// a paint event, without overriding this attribute
-			this->setAttribute(Qt::WA_WState_InPaintEvent, false);
-#endif
-			this->scroll(op.pos.x(), op.pos.y(), op.rect);
-#if QT_VERSION >= 0x050000
-			this->setAttribute(Qt::WA_WState_InPaintEvent);
-#endif
+	QPainter painter(this);
+	foreach(const QRect& r, ev->region().intersected(gridRect).rects()) {
+		painter.drawImage(QRectF(r), m_backing, QRectF(toDevice(r, m_pixelRatio)));
+	}
 
-			m_painter.begin(this);
-
-			// Repaint exposed background. Vim won't redraw areas exposed by
-			// scroll if it considers them empty because it assumes we already
-			// cleared that area of the screen.
-			QRect rect;
-			rect.setWidth(op.rect.width());
-			rect.setHeight(abs(op.pos.y()));
-			if (op.pos.y() > 0)
-				rect.moveTopLeft(op.rect.topLeft());
-			else
-				rect.moveBottomRight(op.rect.bottomRight());
-			m_painter.fillRect(rect, op.color);
-
-			continue; // exception, skip painter restore
-		}
+	// The shell is seldom an exact multiple of the cell size,
+	// paint the margin around the grid
+	foreach(const QRect& r, ev->region().subtracted(gridRect).rects()) {
+		painter.fillRect(r, background());
+	}
 
-		m_painter.restore();
+	m_stats.framePainted(paintTime.nsecsElapsed()/1000, paintedRows, paintedCells);
+	if ( m_stats.frames() == 1 ) {
+		TIME_MSG("GUI: first frame painted");
 	}
-	m_painter.end();
 }
 
 //
@@ -516,22 +894,386 @@ void QVimShell::wheelEvent(QWheelEvent *ev)
  */
 QColor QVimShell::color(const QString& name)
 {
-	QString cname = name.toLower().remove(' ');
-	QColor c = ColorTable::get(cname, QColor());
-	if ( !c.isValid() && cname != "transparent" ) {
-		c.setNamedColor(cname);
+	return ColorTable::get(name);
+}
+
+/*
+ * The grid follows Vim's idea of the shell size, Vim clears
+ * and redraws everything after a resize.
+ */
+void QVimShell::syncGridSize()
+{
+	if ( m_grid.rows() != gui.num_rows || m_grid.columns() != gui.num_cols ) {
+		m_grid.resize(gui.num_rows, gui.num_cols);
+		m_cursorRow = -1;
+		traceResize();
+		scheduleFrame();
+	}
+}
+
+/*
+ * Record drawing calls into a trace, the shell does not take
+ * ownership. Pass 0 to stop recording.
+ */
+void QVimShell::setTrace(DrawTrace *trace)
+{
+	m_trace = trace;
+	traceResize();
+}
+
+/*
+ * The trace needs the shell geometry and font before any
+ * drawing call can be replayed
+ */
+void QVimShell::traceResize()
+{
+	if ( m_trace ) {
+		m_trace->resize(gui.num_rows, gui.num_cols, gui.char_width,
+				gui.char_height, gui.char_ascent, m_fonts.normalFont());
+	}
+}
+
+/*
+ * Request a repaint for the grid damage, at most once per frame
+ */
+void QVimShell::scheduleFrame()
+{
+	if ( m_frameTimer->isActive() ) {
+		return;
+	}
+
+	int wait = frameInterval() - m_frameClock.elapsed();
+	m_frameTimer->start(qMax(wait, 0));
+}
+
+/*
+ * Request a repaint for all the damaged cells in the grid. Damage in
+ * consecutive rows spanning the same columns is merged into a single
+ * rectangle.
+ */
+void QVimShell::presentFrame()
+{
+	m_frameTimer->stop();
+
+	QRegion damage;
+	QRect pending;
+	for (int row=0; row<m_grid.rows(); row++) {
+		if ( !m_grid.isDirty(row) ) {
+			continue;
+		}
+
+		QRect rect = VimWrapper::mapBlock(row, m_grid.dirtyLeft(row),
+						row, m_grid.dirtyRight(row));
+		if ( pending.isValid() && pending.left() == rect.left() &&
+				pending.right() == rect.right() &&
+				pending.bottom()+1 == rect.top() ) {
+			pending.setBottom(rect.bottom());
+		} else {
+			if ( pending.isValid() ) {
+				damage += pending;
+			}
+			pending = rect;
+		}
+	}
+	if ( pending.isValid() ) {
+		damage += pending;
+	}
+
+	// Scrolled pixels in the backing image
+	damage += m_exposed;
+	m_exposed = QRegion();
+
+	if ( !damage.isEmpty() ) {
+		update(damage);
+	}
+	m_frameClock.restart();
+}
+
+/*
+ * Present pending damage if a frame is due, otherwise make
+ * sure the next frame is scheduled
+ */
+void QVimShell::flush()
+{
+	if ( m_trace ) {
+		m_trace->flush();
+	}
+	if ( m_frameClock.elapsed() >= frameInterval() ) {
+		presentFrame();
+	} else {
+		scheduleFrame();
+	}
+}
+
+/*
+ * Frame interval in ms, following the display refresh
+ * rate up to the frame rate cap
+ */
+int QVimShell::frameInterval()
+{
+	qreal rate = 60;
+#if QT_VERSION >= 0x050000
+	QScreen *screen = QGuiApplication::primaryScreen();
+	if ( window()->windowHandle() ) {
+		screen = window()->windowHandle()->screen();
+	}
+	if ( screen && screen->refreshRate() > 0 ) {
+		rate = screen->refreshRate();
+	}
+#endif
+	if ( m_maxFrameRate > 0 && rate > m_maxFrameRate ) {
+		rate = m_maxFrameRate;
+	}
+
+	return qMax(1, qRound(1000/rate));
+}
+
+/*
+ * Number of threads rasterizing large redraws, 1 paints
+ * everything in the GUI thread
+ */
+void QVimShell::setRasterThreads(int threads)
+{
+	threads = qBound(1, threads, MaxRasterThreads);
+#if QT_VERSION >= 0x040800
+	if ( !QFontDatabase::supportsThreadedFontRendering() ) {
+		threads = 1;
+	}
+#else
+	threads = 1;
+#endif
+
+	m_rasterPool->waitForDone();
+	m_rasterPool->setMaxThreadCount(threads);
+	m_bandGlyphs.resize(threads > 1 ? threads : 0);
+	m_grid.markDirty(0, 0, m_grid.rows()-1, m_grid.columns()-1);
+	scheduleFrame();
+}
+
+/*
+ * Cap the number of frames per second, 0 means
+ * the display refresh rate
+ */
+void QVimShell::setMaxFrameRate(int fps)
+{
+	m_maxFrameRate = qMax(fps, 0);
+}
+
+/*
+ * Vim erases the partial and hollow cursors by drawing over
+ * them, forget the cursor if it intersects the given block
+ */
+void QVimShell::dropCursor(int row1, int col1, int row2, int col2)
+{
+	if ( m_cursorRow < row1 || m_cursorRow > row2 ||
+			m_cursorCol2 < col1 || m_cursorCol1 > col2 ) {
+		return;
+	}
+
+	m_grid.markDirty(m_cursorRow, m_cursorCol1, m_cursorRow, m_cursorCol2);
+	scheduleFrame();
+	m_cursorRow = -1;
+}
+
+/*
+ * Place the partial/hollow cursor, only one exists at any time
+ */
+void QVimShell::setCursorShape(const QRect& rect, QRgb color, bool hollow)
+{
+	syncGridSize();
+	dropCursor(0, 0, m_grid.rows()-1, m_grid.columns()-1);
+
+	const int w = VimWrapper::charWidth();
+	const int h = VimWrapper::charHeight();
+	if ( w <= 0 || h <= 0 ) {
+		return;
+	}
+
+	m_cursorRow = rect.top()/h;
+	m_cursorCol1 = rect.left()/w;
+	m_cursorCol2 = rect.right()/w;
+	m_cursorRect = rect;
+	m_cursorColor = color;
+	m_cursorHollow = hollow;
+
+	m_grid.markDirty(m_cursorRow, m_cursorCol1, m_cursorRow, m_cursorCol2);
+
+	// Cursor movement is presented right away, this keeps
+	// keystroke echo latency low
+	presentFrame();
+}
+
+void QVimShell::drawPartCursor(const QRect& rect, QRgb color)
+{
+	if ( m_trace ) {
+		m_trace->partCursor(rect, color);
+	}
+	setCursorShape(rect, color, false);
+}
+
+void QVimShell::drawHollowCursor(const QRect& rect, QRgb color)
+{
+	if ( m_trace ) {
+		m_trace->hollowCursor(rect, color);
+	}
+	setCursorShape(rect, color, true);
+}
+
+/*
+ * Clear the entire grid with the given color
+ */
+void QVimShell::clearAll(QRgb bg)
+{
+	syncGridSize();
+	if ( m_trace ) {
+		m_trace->clear(bg);
 	}
+	m_cursorRow = -1;
+	m_grid.clear(bg);
+	scheduleFrame();
+}
 
-	return c;
+/*
+ * Clear a block of cells row1/col1 to row2/col2 (inclusive)
+ */
+void QVimShell::clearBlock(int row1, int col1, int row2, int col2, QRgb bg)
+{
+	syncGridSize();
+	if ( m_trace ) {
+		m_trace->clearBlock(row1, col1, row2, col2, bg);
+	}
+	dropCursor(row1, col1, row2, col2);
+	m_grid.clearBlock(row1, col1, row2, col2, bg);
+	scheduleFrame();
 }
 
-void QVimShell::queuePaintOp(PaintOperation op)
+/*
+ * Write a string into the grid, flags are Vim's DRAW_* flags
+ */
+void QVimShell::drawString(int row, int col, const QString& str, int flags,
+			QRgb fg, QRgb bg, QRgb sp)
 {
-	paintOps.enqueue(op);
-	if ( op.rect.isValid() ) {
-		update(op.rect);
+	syncGridSize();
+	if ( m_trace ) {
+		m_trace->drawString(row, col, str, flags, fg, bg, sp, m_wideFontSelected);
+	}
+
+	uchar cellFlags = 0;
+	if ( flags & DRAW_BOLD ) {
+		cellFlags |= ShellCell::Bold;
+	}
+	if ( flags & DRAW_ITALIC ) {
+		cellFlags |= ShellCell::Italic;
+	}
+	if ( flags & DRAW_UNDERL ) {
+		cellFlags |= ShellCell::Underline;
+	}
+	if ( flags & DRAW_UNDERC ) {
+		cellFlags |= ShellCell::Undercurl;
+	}
+	if ( m_wideFontSelected ) {
+		cellFlags |= ShellCell::WideFont;
+	}
+
+	bool transparent = flags & DRAW_TRANSP;
+	int len = m_grid.putString(row, col, str, cellFlags, fg, bg, sp, transparent);
+	if ( len == 0 ) {
+		return;
+	}
+
+	// A transparent string is drawn over the partial cursor
+	if ( !transparent ) {
+		dropCursor(row, col, row, col+len-1);
+	}
+
+	// The block cursor is drawn as a string, present it right away
+	if ( flags & DRAW_CURSOR ) {
+		presentFrame();
 	} else {
-		update();
+		scheduleFrame();
+	}
+}
+
+/*
+ * Draw a sign over the two cells at row/col
+ */
+void QVimShell::drawSign(int row, int col, int typenr)
+{
+	syncGridSize();
+	if ( m_trace ) {
+		m_trace->drawSign(row, col, typenr);
+	}
+	m_grid.putSign(row, col, typenr);
+	scheduleFrame();
+}
+
+/*
+ * Invert the colors of a block of cells (inclusive)
+ */
+void QVimShell::invertBlock(int row1, int col1, int row2, int col2)
+{
+	syncGridSize();
+	if ( m_trace ) {
+		m_trace->invertBlock(row1, col1, row2, col2);
+	}
+	m_grid.invertBlock(row1, col1, row2, col2);
+	scheduleFrame();
+}
+
+/*
+ * Scroll a block of cells (inclusive) by count rows, down if count
+ * is positive or up otherwise. The exposed rows are cleared with
+ * the given color.
+ */
+void QVimShell::scrollRows(int row1, int row2, int col1, int col2, int count, QRgb bg)
+{
+	syncGridSize();
+	if ( m_trace ) {
+		m_trace->scrollRows(row1, row2, col1, col2, count, bg);
+	}
+	dropCursor(row1, col1, row2, col2);
+	m_grid.scroll(row1, row2, col1, col2, count, bg);
+
+	// Move the pixels in the backing image, damaged rows moved along
+	// with the grid rows and the scrolled block is presented together
+	// with them in the next frame.
+	// With a fractional pixel ratio rows do not start at whole device
+	// pixels, the block is painted again instead
+	QRect block = VimWrapper::mapBlock(row1, col1, row2, col2)
+				.intersected(QRect(QPoint(0, 0), m_backingSize));
+	if ( block.isEmpty() ) {
+		// Nothing to move
+	} else if ( m_pixelRatio == qRound(m_pixelRatio) ) {
+		int dy = count*VimWrapper::charHeight()*qRound(m_pixelRatio);
+		scrollImage(m_backing, toDevice(block, m_pixelRatio), dy);
+		m_exposed += block;
+	} else {
+		m_grid.markDirty(row1, col1, row2, col2);
+	}
+	scheduleFrame();
+}
+
+/*
+ * Set the shell font, the widget font is only touched
+ * when the font actually changed
+ */
+void QVimShell::setShellFont(const QFont& font)
+{
+	if ( m_fonts.setFont(font) ) {
+		setFont(font);
+		traceResize();
+	}
+}
+
+/*
+ * Set the font for double width characters ('guifontwide'), only
+ * strings drawn while it is selected use it
+ */
+void QVimShell::setWideFont(const QFont& font)
+{
+	if ( m_fonts.setWideFont(font) ) {
+		m_grid.markDirty(0, 0, m_grid.rows()-1, m_grid.columns()-1);
+		scheduleFrame();
 	}
 }
 
@@ -613,9 +1355,11 @@ int QVimShell::charWidth()
 
 void QVimShell::inputMethodEvent(QInputMethodEvent *ev)
 {
+	m_stats.inputReceived();
+
 	if ( !ev->commitString().isEmpty() ) {
 		QByteArray s = VimWrapper::convertTo(ev->commitString());
-		add_to_input_buf_csi( (char_u *) s.data(), s.size() );
+		queueInput( (char_u *) s.data(), s.size(), true );
 		tooltip("");
 	} else {
 		tooltip( ev->preeditString());
@@ -2,41 +2,63 @@
 #define __QVIMSHELL__
 
 #include <QWidget>
-#include <QQueue>
 #include <QLabel>
 #include <QTime>
+#include <QElapsedTimer>
 #include <QPainter>
+#include <QImage>
+#include <QRegion>
+#include <QVector>
+#include <QThreadPool>
 #include "vimwrapper.h"
+#include "shellgrid.h"
+#include "glyphcache.h"
+#include "fontcache.h"
+#include "paintstats.h"
+
+class DrawTrace;
+
+/**
+ * The damaged cells col left..right of a row, painted in a frame
+ */
+class RowSpan
+{
+public:
+	int row, left, right;
+};
 
 
 class QVimShell: public QWidget, public VimWrapper
 {
 	Q_OBJECT
-	Q_ENUMS(PaintOperationType)
 public:
-	enum PaintOperationType { CLEARALL=0, FILLRECT, DRAWSTRING, DRAWRECT, INVERTRECT, SCROLLRECT, DRAWSIGN};
-	class PaintOperation {
-	public:
-		enum QVimShell::PaintOperationType type;
-		QRect rect;
-		QColor color;
-		// DRAWSTRING
-		QFont font;
-		QString str;
-		bool undercurl;
-		QColor curlcolor;
-		// SIGN
-		QPixmap sign;
-		// SCROLL
-		QPoint pos;
-	};
-
 	QVimShell(QWidget *parent=0);
 
 	bool hasInput();
 	static QColor color(const QString&);
 
-	void queuePaintOp(PaintOperation);
+	void clearAll(QRgb bg);
+	void clearBlock(int row1, int col1, int row2, int col2, QRgb bg);
+	void drawString(int row, int col, const QString& str, int flags,
+			QRgb fg, QRgb bg, QRgb sp);
+	void drawSign(int row, int col, int typenr);
+	void invertBlock(int row1, int col1, int row2, int col2);
+	void scrollRows(int row1, int row2, int col1, int col2, int count, QRgb bg);
+	void drawPartCursor(const QRect& rect, QRgb color);
+	void drawHollowCursor(const QRect& rect, QRgb color);
+
+	void flush();
+	void presentPending() {presentFrame();}
+	void setMaxFrameRate(int fps);
+	void setRasterThreads(int threads);
+	void setTrace(DrawTrace *trace);
+
+	void setShellFont(const QFont& font);
+	void setWideFont(const QFont& font);
+	void selectWideFont(bool wide) {m_wideFontSelected = wide;}
+	const FontCache& fonts() const {return m_fonts;}
+	const GlyphCache& glyphs() const {return m_glyphs;}
+	PaintStats& stats() {return m_stats;}
 
 	QColor background();
 	int charWidth();
@@ -78,10 +100,24 @@ protected:
 	virtual void focusOutEvent(QFocusEvent *);
 
 	virtual void paintEvent( QPaintEvent *);
+	void paintPlaceholder(QPainter&);
 
 	QFont fixPainterFont(const QFont &);
-	void drawString(const PaintOperation&, QPainter& );
-	void drawStringSlow( const PaintOperation&, QPainter &painter );
+	void paintRow(QPainter&, GlyphCache&, int row, int col1, int col2);
+	void paintRun(QPainter&, GlyphCache&, int row, int col1, int col2);
+	void paintSigns(QPainter&, int row, int col1, int col2);
+	int paintSpans(const QVector<RowSpan>& spans);
+	void rasterizeBand(QImage band, qreal top, GlyphCache& glyphs,
+			const QVector<RowSpan>& spans, int first, int last);
+
+	void syncGridSize();
+	void traceResize();
+	void syncBacking();
+	qreal pixelRatio() const;
+	void scheduleFrame();
+	int frameInterval();
+	void dropCursor(int row1, int col1, int row2, int col2);
+	void setCursorShape(const QRect& rect, QRgb color, bool hollow);
 
 
 	int_u vimKeyboardModifiers(Qt::KeyboardModifiers);
@@ -97,17 +133,27 @@ protected:
 	virtual void enterEvent(QEvent *ev);
 	bool focusNextPrevChild(bool next);
 
+	friend class RowBandJob;
+
 private slots:
+	void presentFrame();
+	void commitResize();
 	void cursorOff();
 	void cursorOn();
 	void startBlinkOffTimer();
 	void startBlinkOnTimer();
 
 private:
+	// Redraws smaller than this many cells per thread are
+	// painted in the GUI thread
+	static const int ParallelCells = 2048;
+	static const int MaxRasterThreads = 16;
+	// Frames without a resize before Vim gets the new size
+	static const int ResizeSettleFrames = 2;
+
 	QColor m_background;
 	int m_charWidth;
 	QFont m_font;
-	QPainter m_painter;
 
 	QTimer * timer_cursorBlinkOn ;
 	QTimer * timer_cursorBlinkOff ;
@@ -121,7 +167,27 @@ private:
 	blink_state blinkState;
 	bool m_encoding_utf8;
 
-	QQueue<PaintOperation> paintOps;
+	ShellGrid m_grid;
+	FontCache m_fonts;
+	GlyphCache m_glyphs;
+	bool m_wideFontSelected;
+
+	// Rasterized grid, scrolling moves pixels in place
+	QImage m_backing;
+	QSize m_backingSize;
+	qreal m_pixelRatio;
+	QRegion m_exposed;
+
+	// Large redraws are split in row bands rasterized in parallel,
+	// each band has its own glyph cache
+	QThreadPool *m_rasterPool;
+	QVector<GlyphCache> m_bandGlyphs;
+
+	// Partial or hollow cursor drawn over the grid
+	int m_cursorRow, m_cursorCol1, m_cursorCol2;
+	QRect m_cursorRect;
+	QRgb m_cursorColor;
+	bool m_cursorHollow;
 
 	QTime m_lastClick;
 	int m_lastClickEvent;
@@ -129,6 +195,16 @@ private:
 
 	bool m_slowStringDrawing;
 	bool m_mouseHidden;
+
+	PaintStats m_stats;
+	DrawTrace *m_trace;
+
+	QTimer *m_resizeTimer;
+	QSize m_resizeSize, m_committedSize;
+
+	QTimer *m_frameTimer;
+	QElapsedTimer m_frameClock;
+	int m_maxFrameRate;
 };
 
 struct special_key
@@ -0,0 +1,352 @@
+#include "shellgrid.h"
+#include "vimwrapper.h"
+
+#include <algorithm>
+
+extern "C" {
+#include "vim.h"
+}
+
+ShellGrid::ShellGrid()
+:m_columns(0)
+{
+	m_blank.ch = ' ';
+	m_blank.fg = qRgb(0, 0, 0);
+	m_blank.bg = qRgb(255, 255, 255);
+	m_blank.sp = m_blank.fg;
+	m_blank.flags = 0;
+}
+
+/**
+ * Resize the grid, preserving the overlapping contents
+ *
+ * New cells are blank and the whole grid is marked dirty
+ */
+void ShellGrid::resize(int rows, int columns)
+{
+	if ( rows < 0 ) {
+		rows = 0;
+	}
+	if ( columns < 0 ) {
+		columns = 0;
+	}
+
+	int oldRows = m_rows.size();
+	m_rows.resize(rows);
+	for (int row=0; row<rows; row++) {
+		Row& r = m_rows[row];
+		if ( row >= oldRows ) {
+			r.cells.fill(m_blank, columns);
+			continue;
+		}
+
+		int oldColumns = r.cells.size();
+		r.cells.resize(columns);
+		for (int col=oldColumns; col<columns; col++) {
+			r.cells[col] = m_blank;
+		}
+		if ( columns < oldColumns ) {
+			QMutableHashIterator<int, QString> it(r.composing);
+			while (it.hasNext()) {
+				if ( it.next().key() >= columns ) {
+					it.remove();
+				}
+			}
+		}
+	}
+
+	m_columns = columns;
+	markDirty(0, 0, rows-1, columns-1);
+}
+
+/**
+ * The text of a cell, including any composing characters
+ */
+QString ShellGrid::text(int row, int col) const
+{
+	const Row& r = m_rows.at(row);
+	uint ch = r.cells.at(col).ch;
+	QString s = QString::fromUcs4(&ch, 1);
+	if ( !r.composing.isEmpty() ) {
+		s += r.composing.value(col);
+	}
+	return s;
+}
+
+bool ShellGrid::isComposed(int row, int col) const
+{
+	const Row& r = m_rows.at(row);
+	return !r.composing.isEmpty() && r.composing.contains(col);
+}
+
+/**
+ * Clip a block to the grid, returns false if nothing is left
+ */
+bool ShellGrid::clip(int& row1, int& col1, int& row2, int& col2) const
+{
+	row1 = qMax(row1, 0);
+	col1 = qMax(col1, 0);
+	row2 = qMin(row2, rows()-1);
+	col2 = qMin(col2, columns()-1);
+
+	return row1 <= row2 && col1 <= col2;
+}
+
+void ShellGrid::markDirty(int row1, int col1, int row2, int col2)
+{
+	if ( !clip(row1, col1, row2, col2) ) {
+		return;
+	}
+
+	for (int row=row1; row<=row2; row++) {
+		Row& r = m_rows[row];
+		if ( r.dirtyLeft == -1 ) {
+			r.dirtyLeft = col1;
+			r.dirtyRight = col2;
+		} else {
+			r.dirtyLeft = qMin(r.dirtyLeft, col1);
+			r.dirtyRight = qMax(r.dirtyRight, col2);
+		}
+	}
+}
+
+void ShellGrid::setClean(int row)
+{
+	m_rows[row].dirtyLeft = -1;
+	m_rows[row].dirtyRight = -1;
+}
+
+/**
+ * Clear the grid with the given background color
+ */
+void ShellGrid::clear(QRgb bg)
+{
+	m_blank.bg = bg;
+	m_blank.fg = bg;
+	m_blank.sp = bg;
+
+	for (int row=0; row<rows(); row++) {
+		Row& r = m_rows[row];
+		r.cells.fill(m_blank);
+		r.composing.clear();
+	}
+	markDirty(0, 0, rows()-1, columns()-1);
+}
+
+/**
+ * Clear the block from row1/col1 to row2/col2 (inclusive)
+ */
+void ShellGrid::clearBlock(int row1, int col1, int row2, int col2, QRgb bg)
+{
+	if ( !clip(row1, col1, row2, col2) ) {
+		return;
+	}
+
+	ShellCell blank = m_blank;
+	blank.fg = blank.bg = blank.sp = bg;
+
+	for (int row=row1; row<=row2; row++) {
+		Row& r = m_rows[row];
+		ShellCell *cells = r.cells.data();
+		std::fill(cells + col1, cells + col2 + 1, blank);
+		if ( !r.composing.isEmpty() ) {
+			for (int col=col1; col<=col2; col++) {
+				r.composing.remove(col);
+			}
+		}
+	}
+	markDirty(row1, col1, row2, col2);
+}
+
+/**
+ * Write a string into the grid starting at row/col
+ *
+ * Composing characters are attached to the preceding cell and
+ * double width characters take two cells. When transparent is
+ * true the cell background is left untouched.
+ *
+ * Returns the number of cells written
+ */
+int ShellGrid::putString(int row, int col, const QString& str, uchar flags,
+			QRgb fg, QRgb bg, QRgb sp, bool transparent)
+{
+	if ( row < 0 || row >= rows() || col < 0 || col >= columns() ) {
+		return 0;
+	}
+
+	Row& r = m_rows[row];
+	const ushort *s = str.utf16();
+	const int len = str.size();
+	int start = col;
+
+	int i = 0;
+	while ( i < len ) {
+		// Runs of ASCII text take one cell per character
+		int ascii = qMin(VimWrapper::asciiPrefix(s + i, len - i), columns() - col);
+		for (int end=i+ascii; i<end; i++, col++) {
+			ShellCell& cell = r.cells[col];
+			cell.ch = s[i];
+			cell.fg = fg;
+			if ( !transparent ) {
+				cell.bg = bg;
+			}
+			cell.sp = sp;
+			cell.flags = flags;
+		}
+		if ( ascii > 0 && !r.composing.isEmpty() ) {
+			for (int c=col-ascii; c<col; c++) {
+				r.composing.remove(c);
+			}
+		}
+		if ( i >= len || s[i] < 0x80 ) {
+			// Done, or out of columns
+			break;
+		}
+
+		uint ch = s[i++];
+		if ( QChar::isHighSurrogate(ch) && i < len && QChar::isLowSurrogate(s[i]) ) {
+			ch = QChar::surrogateToUcs4(ch, s[i++]);
+		}
+
+		int width = VimWrapper::cellWidth(ch);
+		if ( width == 0 && col > start ) {
+			int base = col - 1;
+			if ( r.cells.at(base).ch == 0 && base > start ) {
+				base--;
+			}
+			r.composing[base] += QString::fromUcs4(&ch, 1);
+			continue;
+		}
+
+		width = qMax(width, 1);
+		if ( col + width > columns() ) {
+			break;
+		}
+
+		for (int w=0; w<width; w++) {
+			ShellCell& cell = r.cells[col+w];
+			cell.ch = (w == 0) ? ch : 0;
+			cell.fg = fg;
+			if ( !transparent ) {
+				cell.bg = bg;
+			}
+			cell.sp = sp;
+			cell.flags = flags;
+		}
+		if ( !r.composing.isEmpty() ) {
+			r.composing.remove(col);
+			if ( width == 2 ) {
+				r.composing.remove(col+1);
+			}
+		}
+		col += width;
+	}
+
+	markDirty(row, start, row, col-1);
+	return col - start;
+}
+
+/**
+ * Place a sign over the two cells at row/col
+ */
+void ShellGrid::putSign(int row, int col, int typenr)
+{
+	if ( row < 0 || row >= rows() || col < 0 || col >= columns() ) {
+		return;
+	}
+
+	ShellCell& cell = m_rows[row].cells[col];
+	cell.ch = typenr;
+	cell.flags |= ShellCell::Sign;
+	markDirty(row, col, row, col+1);
+}
+
+/**
+ * Toggle inversion for the block from row1/col1 to row2/col2 (inclusive)
+ */
+void ShellGrid::invertBlock(int row1, int col1, int row2, int col2)
+{
+	if ( !clip(row1, col1, row2, col2) ) {
+		return;
+	}
+
+	for (int row=row1; row<=row2; row++) {
+		Row& r = m_rows[row];
+		for (int col=col1; col<=col2; col++) {
+			r.cells[col].flags ^= ShellCell::Inverted;
+		}
+	}
+	markDirty(row1, col1, row2, col2);
+}
+
+/**
+ * Copy the cells col1..col2 of one row into another row
+ */
+void ShellGrid::copyCells(int from, int to, int col1, int col2)
+{
+	Row& dst = m_rows[to];
+	const Row& src = m_rows.at(from);
+
+	std::copy(src.cells.constData() + col1, src.cells.constData() + col2 + 1,
+			dst.cells.data() + col1);
+
+	for (int col=col1; col<=col2; col++) {
+		dst.composing.remove(col);
+	}
+	QHashIterator<int, QString> it(src.composing);
+	while (it.hasNext()) {
+		it.next();
+		if ( it.key() >= col1 && it.key() <= col2 ) {
+			dst.composing.insert(it.key(), it.value());
+		}
+	}
+
+	// Pending damage moves with the contents
+	if ( src.dirtyLeft != -1 && src.dirtyLeft <= col2 && src.dirtyRight >= col1 ) {
+		markDirty(to, qMax(src.dirtyLeft, col1), to, qMin(src.dirtyRight, col2));
+	}
+}
+
+/**
+ * Scroll the block row1/col1 to row2/col2 (inclusive) by count rows,
+ * downwards if count is positive or upwards otherwise. Rows exposed
+ * by the scroll are cleared with the given background color.
+ *
+ * Dirty state moves along with the rows, the exposed rows are
+ * marked dirty.
+ */
+void ShellGrid::scroll(int row1, int row2, int col1, int col2, int count, QRgb bg)
+{
+	if ( !clip(row1, col1, row2, col2) || count == 0 ) {
+		return;
+	}
+
+	if ( qAbs(count) > row2 - row1 ) {
+		clearBlock(row1, col1, row2, col2, bg);
+		return;
+	}
+
+	bool fullWidth = (col1 == 0 && col2 == columns()-1);
+
+	if ( count > 0 ) {
+		for (int row=row2; row>=row1+count; row--) {
+			if ( fullWidth ) {
+				qSwap(m_rows[row], m_rows[row-count]);
+			} else {
+				copyCells(row-count, row, col1, col2);
+			}
+		}
+		clearBlock(row1, col1, row1+count-1, col2, bg);
+	} else {
+		count = -count;
+		for (int row=row1; row<=row2-count; row++) {
+			if ( fullWidth ) {
+				qSwap(m_rows[row], m_rows[row+count]);
+			} else {
+				copyCells(row+count, row, col1, col2);
+			}
+		}
+		clearBlock(row2-count+1, col1, row2, col2, bg);
+	}
+}
+
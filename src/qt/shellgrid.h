@@ -0,0 +1,91 @@
+#ifndef __VIM_QT_SHELLGRID__
+#define __VIM_QT_SHELLGRID__
+
+#include <QVector>
+#include <QHash>
+#include <QString>
+#include <QColor>
+
+/**
+ * A single character cell of the shell
+ *
+ * Double width characters take two cells, the right half
+ * is stored as a cell with ch == 0.
+ */
+class ShellCell
+{
+public:
+	enum Flag { Bold=0x01, Italic=0x02, Underline=0x04,
+			Undercurl=0x08, Inverted=0x10, Sign=0x20,
+			WideFont=0x40 };
+
+	uint ch;	// UCS-4 codepoint, or the sign type for Sign cells
+	QRgb fg;
+	QRgb bg;
+	QRgb sp;
+	uchar flags;
+
+	QRgb foreground() const {
+		return (flags & Inverted) ? fg ^ 0x00FFFFFF : fg;
+	}
+	QRgb background() const {
+		return (flags & Inverted) ? bg ^ 0x00FFFFFF : bg;
+	}
+};
+
+/**
+ * ShellGrid holds the retained contents of the shell as a grid of
+ * rows and columns. The gui_mch_* drawing functions mutate the grid
+ * and the shell rasterizes it when painting.
+ *
+ * Each row keeps the range of columns that changed since it was
+ * last painted.
+ */
+class ShellGrid
+{
+public:
+	ShellGrid();
+
+	void resize(int rows, int columns);
+	int rows() const { return m_rows.size(); }
+	int columns() const { return m_columns; }
+
+	const ShellCell& cell(int row, int col) const {
+		return m_rows.at(row).cells.at(col);
+	}
+	QString text(int row, int col) const;
+	bool isComposed(int row, int col) const;
+
+	void clear(QRgb bg);
+	void clearBlock(int row1, int col1, int row2, int col2, QRgb bg);
+	int putString(int row, int col, const QString& str, uchar flags,
+			QRgb fg, QRgb bg, QRgb sp, bool transparent);
+	void putSign(int row, int col, int typenr);
+	void invertBlock(int row1, int col1, int row2, int col2);
+	void scroll(int row1, int row2, int col1, int col2, int count, QRgb bg);
+
+	bool isDirty(int row) const { return m_rows.at(row).dirtyLeft != -1; }
+	int dirtyLeft(int row) const { return m_rows.at(row).dirtyLeft; }
+	int dirtyRight(int row) const { return m_rows.at(row).dirtyRight; }
+	void markDirty(int row1, int col1, int row2, int col2);
+	void setClean(int row);
+
+protected:
+	class Row {
+	public:
+		Row() :dirtyLeft(-1), dirtyRight(-1) {}
+		QVector<ShellCell> cells;
+		QHash<int, QString> composing;
+		int dirtyLeft, dirtyRight;
+	};
+
+	bool clip(int& row1, int& col1, int& row2, int& col2) const;
+	void copyCells(int from, int to, int col1, int col2);
+
+private:
+	QVector<Row> m_rows;
+	int m_columns;
+	ShellCell m_blank;
+};
+
+#endif
@@ -0,0 +1,26 @@
+#include "signicon.h"
+
+SignIcon::SignIcon(const QIcon& icon)
+:m_icon(icon), m_ratio(0)
+{
+}
+
+/**
+ * The icon rendered at the given size, in device independent pixels
+ */
+const QPixmap& SignIcon::pixmap(const QSize& size, qreal ratio)
+{
+	if ( size == m_size && ratio == m_ratio && !m_pixmap.isNull() ) {
+		return m_pixmap;
+	}
+
+	m_size = size;
+	m_ratio = ratio;
+#if QT_VERSION >= 0x050000
+	m_pixmap = m_icon.pixmap(size*ratio);
+	m_pixmap.setDevicePixelRatio(ratio);
+#else
+	m_pixmap = m_icon.pixmap(size);
+#endif
+	return m_pixmap;
+}
@@ -0,0 +1,28 @@
+#ifndef __VIM_QT_SIGNICON__
+#define __VIM_QT_SIGNICON__
+
+#include <QIcon>
+#include <QPixmap>
+
+/**
+ * SignIcon is the image registered for a sign (:sign define icon=)
+ *
+ * Scaling an icon is expensive, specially for SVG icons. The pixmap
+ * for the current cell size and device pixel ratio is kept around,
+ * a font change renders it again.
+ */
+class SignIcon
+{
+public:
+	SignIcon(const QIcon& icon);
+
+	const QPixmap& pixmap(const QSize& size, qreal ratio=1.0);
+
+private:
+	QIcon m_icon;
+	QPixmap m_pixmap;
+	QSize m_size;
+	qreal m_ratio;
+};
+
+#endif
@@ -56,5 +56,6 @@ VimAction::VimAction(vimmenu_T* menu, QObject *parent)
 
 void VimAction::actionTriggered()
 {
+	VimWrapper::flushInput();
 	gui_menu_cb(m_menu);
 }
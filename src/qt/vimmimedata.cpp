@@ -0,0 +1,85 @@
+#include "vimmimedata.h"
+
+#include <QDataStream>
+
+const char *VimMimeData::SelectionTypeMime = "application/x-vim-qt-selection-type";
+
+VimMimeData::VimMimeData(VimClipboard *cbd)
+:m_cbd(cbd), m_converted(false), m_type(-1), m_str(NULL)
+{
+}
+
+VimMimeData::~VimMimeData()
+{
+	vim_free(m_str);
+}
+
+QStringList VimMimeData::formats() const
+{
+	return QStringList() << "text/plain" << SelectionTypeMime;
+}
+
+bool VimMimeData::hasFormat(const QString& mimetype) const
+{
+	return mimetype == "text/plain" || mimetype == SelectionTypeMime;
+}
+
+/**
+ * Yank and convert the selection, the first time only. Returns
+ * false if Vim has no selection.
+ */
+bool VimMimeData::convert() const
+{
+	if ( m_converted ) {
+		return m_type >= 0;
+	}
+	m_converted = true;
+
+	int owned = m_cbd->owned;
+	m_cbd->owned = TRUE;
+	clip_get_selection(m_cbd);
+	m_cbd->owned = owned;
+
+	long_u size = 0;
+	m_type = clip_convert_selection(&m_str, &size, m_cbd);
+	if ( m_type < 0 ) {
+		return false;
+	}
+
+	// The text stays in Vim's buffer until we are deleted
+	m_text = QByteArray::fromRawData((const char *)m_str, size);
+	return true;
+}
+
+/**
+ * The selection text in Vim's encoding and its motion type, this
+ * avoids a round trip through QString when Vim pastes its own
+ * selection
+ */
+bool VimMimeData::selection(QByteArray& text, int& type) const
+{
+	if ( !convert() ) {
+		return false;
+	}
+
+	text = m_text;
+	type = m_type;
+	return true;
+}
+
+QVariant VimMimeData::retrieveData(const QString& mimetype, QVariant::Type type) const
+{
+	if ( !hasFormat(mimetype) || !convert() ) {
+		return QVariant();
+	}
+
+	if ( mimetype == SelectionTypeMime ) {
+		// Serialized motion type, see clip_mch_request_selection()
+		QByteArray payload;
+		QDataStream serialize(&payload, QIODevice::WriteOnly);
+		serialize << m_type;
+		return payload;
+	}
+
+	return VimWrapper::convertFrom(m_text);
+}
@@ -0,0 +1,41 @@
+#ifndef __VIM_QT_VIMMIMEDATA__
+#define __VIM_QT_VIMMIMEDATA__
+
+#include <QMimeData>
+#include <QStringList>
+#include "vimwrapper.h"
+
+/**
+ * VimMimeData publishes a Vim selection ('*' or '+') to the clipboard
+ *
+ * The selection is only yanked and converted when a format is
+ * actually requested, the result is kept for later requests. Setting
+ * the selection is cheap even when it is huge, and with 'clipboard'
+ * set to autoselect it happens for every change of the Visual area.
+ */
+class VimMimeData: public QMimeData
+{
+public:
+	VimMimeData(VimClipboard *cbd);
+	virtual ~VimMimeData();
+
+	virtual QStringList formats() const;
+	virtual bool hasFormat(const QString& mimetype) const;
+
+	bool selection(QByteArray& text, int& type) const;
+
+	static const char *SelectionTypeMime;
+
+protected:
+	virtual QVariant retrieveData(const QString& mimetype, QVariant::Type type) const;
+	bool convert() const;
+
+private:
+	VimClipboard *m_cbd;
+	mutable bool m_converted;
+	mutable int m_type;
+	mutable char_u *m_str;
+	mutable QByteArray m_text;
+};
+
+#endif
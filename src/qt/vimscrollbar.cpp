@@ -13,6 +13,7 @@ void VimScrollBar::dragging()
 		return;
 	}
 
+	VimWrapper::flushInput();
 	gui_drag_scrollbar(sb, this->value(), 1);
 }
 
@@ -22,6 +23,7 @@ void VimScrollBar::draggingFinished()
 		return;
 	}
 
+	VimWrapper::flushInput();
 	gui_drag_scrollbar(sb, this->value(), 0);
 }
 
@@ -1,7 +1,13 @@
 #include <QApplication>
 #include <QStyle>
 #include <QMetaType>
-#include <QTime>
+#include <QAbstractEventDispatcher>
+#include <QEventLoop>
+#include <QTimer>
+#include <string.h>
+#ifdef __SSE2__
+# include <emmintrin.h>
+#endif
 #include "vimwrapper.h"
 
 extern "C" {
@@ -11,7 +17,7 @@ extern "C" {
 Q_DECLARE_METATYPE( QList<QUrl> );
 
 VimWrapper::VimWrapper()
-:m_processInputOnly(false)
+:m_processInputOnly(false), m_waitLoop(0), m_waitWoken(false)
 {
 	qRegisterMetaType<QList<QUrl> >("URLList");
 
@@ -60,22 +66,60 @@ void VimWrapper::guiShellClosed()
 void VimWrapper::guiSendMouseEvent(int button, int x, int y, int repeated_click, unsigned int modifiers)
 {
 	// This is safe
+	flushInput();
 	gui_send_mouse_event(button, x, y, repeated_click, modifiers);
 }
 
+char_u VimWrapper::m_input[InputBatchSize];
+int VimWrapper::m_inputLen = 0;
+
+/*
+ * Queue bytes for Vim's input buffer, if escapeCsi is true CSI
+ * bytes are escaped like add_to_input_buf_csi() does.
+ *
+ * Key events arrive in bursts (key repeat, typed paste), they are
+ * handed to Vim together by flushInput(). Anything else that writes
+ * to the input buffer has to flush first to keep the order.
+ */
+void VimWrapper::queueInput(const char_u *s, int len, bool escapeCsi)
+{
+	for (int i=0; i<len; i++) {
+		if ( m_inputLen + 3 > InputBatchSize ) {
+			flushInput();
+		}
+
+		m_input[m_inputLen++] = s[i];
+		if ( escapeCsi && s[i] == CSI ) {
+			m_input[m_inputLen++] = KS_EXTRA;
+			m_input[m_inputLen++] = (int)KE_CSI;
+		}
+	}
+}
+
+void VimWrapper::flushInput()
+{
+	if ( m_inputLen > 0 ) {
+		add_to_input_buf(m_input, m_inputLen);
+		m_inputLen = 0;
+	}
+}
+
 void VimWrapper::guiMouseMoved(int x, int y)
 {
+	flushInput();
 	gui_mouse_moved(x, y);
 }
 
 void VimWrapper::guiFocusChanged(int focus)
 {
+	flushInput();
 	gui_focus_change(focus);
 }
 
 void VimWrapper::sendTablineEvent(int ev)
 {
 	// This just writes to the input buf
+	flushInput();
 	send_tabline_event(ev);
 }
 
@@ -93,6 +137,7 @@ void VimWrapper::undrawCursor()
 void VimWrapper::sendTablineMenuEvent(int idx, int ev)
 {
 	// This just writes to the input buf
+	flushInput();
 	send_tabline_menu_event(idx, ev);
 }
 
@@ -106,6 +151,7 @@ void VimWrapper::guiHandleDropText(const QString& s)
 	dnd_yank_drag_data( (char_u*)text.data(), text.size());
 
 	char_u buf[3] = {CSI, KS_EXTRA, (char_u)KE_DROP};
+	flushInput();
 	add_to_input_buf(buf, 3);
 }
 
@@ -138,6 +184,7 @@ void VimWrapper::guiHandleDrop(const QPoint& pos, unsigned int mod, const QList<
 			s[j]='\0';
 			fnames[i] = (char_u *) s;
 		}
+		flushInput();
 		gui_handle_drop(pos.x(), pos.y(), mod, fnames, urls.size());
 	}
 }
@@ -212,18 +259,91 @@ int VimWrapper::charCellWidth(const QChar& c)
 	return 0;
 }
 
+/*
+ * Cell width of a string, surrogate pairs are handled
+ * as a single character
+ */
 int VimWrapper::stringCellWidth(const QString& s)
 {
-	/*
-	 * Vim kindly provides us with utf_char2cells,
-	 * unfortunately Qt does not have a way measure
-	 * wide char length.
-	 */
-	int len=0;
-	foreach ( QChar c, s ) {
-		len += charCellWidth(c);
+	const ushort *str = s.utf16();
+	const int len = s.size();
+	int cells = 0;
+
+	int i = 0;
+	while ( i < len ) {
+		int ascii = asciiPrefix(str + i, len - i);
+		cells += ascii;
+		i += ascii;
+		if ( i >= len ) {
+			break;
+		}
+
+		uint ucs = str[i++];
+		if ( QChar::isHighSurrogate(ucs) && i < len && QChar::isLowSurrogate(str[i]) ) {
+			ucs = QChar::surrogateToUcs4(ucs, str[i++]);
+		}
+		cells += cellWidth(ucs);
+	}
+	return cells;
+}
+
+/*
+ * Length of the ASCII prefix of a UTF-16 string
+ */
+int VimWrapper::asciiPrefix(const ushort *s, int len)
+{
+	int i = 0;
+#ifdef __SSE2__
+	const __m128i high = _mm_set1_epi16((short)0xFF80);
+	const __m128i zero = _mm_setzero_si128();
+	for (; i+8<=len; i+=8) {
+		__m128i v = _mm_loadu_si128((const __m128i *)(s + i));
+		__m128i ascii = _mm_cmpeq_epi16(_mm_and_si128(v, high), zero);
+		if ( _mm_movemask_epi8(ascii) != 0xFFFF ) {
+			break;
+		}
+	}
+#endif
+	while ( i < len && s[i] < 0x80 ) {
+		i++;
+	}
+	return i;
+}
+
+/*
+ * The cell width of all BMP codepoints, two bits each. The widths
+ * depend on 'ambiwidth' and 'emoji' - the table is rebuilt when
+ * they change.
+ */
+static uchar bmpCellWidths[0x10000/4];
+static int bmpCellWidthsKey = -1;
+
+static int slowCellWidth(uint ucs)
+{
+	if ( utf_iscomposing(ucs) ) {
+		return 0;
+	}
+	return (utf_char2cells(ucs) == 2) ? 2 : 1;
+}
+
+int VimWrapper::cellWidth(uint ucs)
+{
+	if ( ucs < 0x80 ) {
+		return 1;
+	} else if ( ucs > 0xFFFF ) {
+		return slowCellWidth(ucs);
 	}
-	return len;
+
+	int key = (*p_ambw == 'd' ? 1 : 0) | (p_emoji ? 2 : 0);
+	if ( key != bmpCellWidthsKey ) {
+		memset(bmpCellWidths, 0, sizeof(bmpCellWidths));
+		for (uint c=0x80; c<=0xFFFF; c++) {
+			bmpCellWidths[c >> 2] |= slowCellWidth(c) << ((c & 3)*2);
+		}
+		bmpCellWidthsKey = key;
+	}
+
+	return (bmpCellWidths[ucs >> 2] >> ((ucs & 3)*2)) & 0x03;
 }
 
 bool VimWrapper::isFakeMonospace(QFont f)
@@ -323,6 +443,16 @@ VimWrapper::fromColor(long color)
 	return QColor(red, green, blue);
 }
 
+/**
+ * Convert a Vim color into a packed QRgb, this is what
+ * the shell stores and paints with
+ */
+QRgb
+VimWrapper::fromColorRgb(long color)
+{
+	return 0xFF000000 | (color & 0x00FFFFFF);
+}
+
 long
 VimWrapper::toColor(const QColor& c)
 {
@@ -389,6 +519,7 @@ bool VimWrapper::processEvents(long wtime, bool inputOnly)
 {
 	bool prev = m_processInputOnly;
 	m_processInputOnly = inputOnly;
+	flushInput();
 
 	// Process pending events
 	if (!inputOnly) {
@@ -399,27 +530,58 @@ bool VimWrapper::processEvents(long wtime, bool inputOnly)
 		}
 	}
 
-	int ret = FAIL;
-	if ( wtime == -1 ) {
-		QApplication::processEvents( QEventLoop::WaitForMoreEvents);
-	} else if ( wtime == 0 ) {
+	if ( wtime == 0 ) {
 		if ( !hasPendingEvents() && vim_is_input_buf_empty() ) {
+			m_processInputOnly = prev;
 			return OK;
 		}
 		QApplication::processEvents();
-	} else {
-		QTime t;
-		t.start();
-		do {
+		flushInput();
+	} else if ( !hasPendingEvents() && vim_is_input_buf_empty() ) {
+		// Sleep in the event loop until there is input, the deadline
+		// expires or someone calls wakeUp()
+		QEventLoop loop;
+		QTimer deadline;
+		deadline.setSingleShot(true);
+		QObject::connect(&deadline, SIGNAL(timeout()), &loop, SLOT(quit()));
+		if ( wtime > 0 ) {
+			deadline.start(wtime);
+		}
 
-			QApplication::processEvents( QEventLoop::WaitForMoreEvents);
+		QEventLoop *outer = m_waitLoop;
+		m_waitLoop = &loop;
+#if QT_VERSION >= 0x050000
+		QMetaObject::Connection check = QObject::connect(
+				QAbstractEventDispatcher::instance(),
+				&QAbstractEventDispatcher::aboutToBlock,
+				[this, &loop]() {
+					// All pending key events were delivered
+					flushInput();
+					if ( hasPendingEvents() || !vim_is_input_buf_empty() ) {
+						loop.quit();
+					}
+				});
+		loop.exec();
+		QObject::disconnect(check);
+#else
+		// Qt4 can't connect aboutToBlock to a lambda, check for
+		// input each time the loop has processed events instead
+		bool outerWoken = m_waitWoken;
+		m_waitWoken = false;
+		while ( !m_waitWoken && (wtime < 0 || deadline.isActive()) ) {
+			loop.processEvents(QEventLoop::WaitForMoreEvents);
+			flushInput();
 			if ( hasPendingEvents() || !vim_is_input_buf_empty() ) {
-				goto out;
+				break;
 			}
-		} while( t.elapsed() < wtime );
+		}
+		m_waitWoken = outerWoken;
+#endif
+		m_waitLoop = outer;
+		// Keys that arrived while leaving the loop
+		flushInput();
 	}
 
-out:
 	m_processInputOnly = prev;
 	if ( hasPendingEvents() || !vim_is_input_buf_empty() ) {
 		return OK;
@@ -428,6 +590,18 @@ out:
 	}
 }
 
+/**
+ * Interrupt a blocking processEvents() call, e.g. because
+ * a channel has messages to be parsed
+ */
+void VimWrapper::wakeUp()
+{
+	if ( m_waitLoop ) {
+		m_waitLoop->quit();
+		m_waitWoken = true;
+	}
+}
+
 bool VimWrapper::hasPendingEvents()
 {
 	return pendingEvents.size() != 0;
@@ -13,6 +13,8 @@ extern "C" {
 
 #include "vimevents.h"
 
+class QEventLoop;
+
 /**
  * VimWrapper is wrapper around Vim, it handles conversion between Qt types
  * and vim function's argument types
@@ -59,6 +61,12 @@ public:
 
 	static int stringCellWidth(const QString&);
 	static int charCellWidth(const QChar&);
+
+	/**
+	 * Cell width of a codepoint, 0 for composing characters
+	 */
+	static int cellWidth(uint ucs);
+	static int asciiPrefix(const ushort *s, int len);
 	static bool isFakeMonospace(QFont );
 
 	/**
@@ -67,6 +75,7 @@ public:
 	static QIcon icon(const QString&);
 
 	static QColor fromColor(long);
+	static QRgb fromColorRgb(long);
 	static long toColor(const QColor&);
 
 	/**
@@ -101,13 +110,23 @@ public:
 	static void setFullscreen(bool on);
 	void setProcessInputOnly(bool input_only);
 	bool processEvents(long wtime=0, bool inputOnly=false);
+	void wakeUp();
+
+	static void queueInput(const char_u *s, int len, bool escapeCsi=false);
+	static void flushInput();
 
 protected:
 	static QString convertFrom(const char *, int size=-1);
 	bool hasPendingEvents();
 
 private:
+	static const int InputBatchSize = 256;
+	static char_u m_input[InputBatchSize];
+	static int m_inputLen;
+
 	bool m_processInputOnly;
+	QEventLoop *m_waitLoop;
+	bool m_waitWoken;
 	QList<VimEvent *> pendingEvents;
 };
 
@@ -592,6 +592,35 @@ typedef struct
 
 #define MF_SEED_LEN	8
 
+#ifdef FEAT_LAZYREAD
+/*
+ * Data blocks of a file that is read lazily, see 'lazyread'.  Block
+ * "mm_first - n" holds the lines of mm_blocks[n].  As long as mb_mapped is
+ * set the block can be made again from the text in the mapped file, it
+ * doesn't need to be kept in memory or in the swap file.
+ */
+typedef struct
+{
+    off_T	mb_offset;		/* offset of the text in the file */
+    int		mb_len;			/* length of the text */
+    int		mb_line_count;		/* number of lines in the text */
+    int		mb_mapped;		/* block was not changed */
+} lazyblock_T;
+
+typedef struct
+{
+    char_u	*mm_base;		/* start of the mapping */
+    off_T	mm_len;			/* length of the mapping */
+    dev_t	mm_dev;			/* device of the mapped file */
+    ino_t	mm_ino;			/* inode of the mapped file */
+    int		mm_dos;			/* lines end in CR-NL */
+    blocknr_T	mm_first;		/* block number of mm_blocks[0] */
+    long	mm_count;		/* number of entries in mm_blocks */
+    lazyblock_T	*mm_blocks;
+    int		mm_truncated;		/* file was found to be truncated */
+} lazyfile_T;
+#endif
+
 struct memfile
 {
     char_u	*mf_fname;		/* name of the file */
@@ -610,6 +639,13 @@ struct memfile
     blocknr_T	mf_infile_count;	/* number of pages in the file */
     unsigned	mf_page_size;		/* number of bytes in a page */
     int		mf_dirty;		/* TRUE if there are dirty blocks */
+#ifdef FEAT_LAZYREAD
+    lazyfile_T	*mf_mapped;		/* file that is read lazily or NULL */
+#endif
+#ifdef FEAT_SWAP_THREAD
+    int		mf_jobs;		/* nr of jobs for the writer thread */
+    int		mf_job_error;		/* TRUE when one of them failed */
+#endif
 #ifdef FEAT_CRYPT
     buf_T	*mf_buffer;		/* buffer this memfile is for */
     char_u	mf_seed[MF_SEED_LEN];	/* seed for encryption */
@@ -638,6 +674,24 @@ typedef struct info_pointer
     int		ip_index;	/* index for block with current lnum */
 } infoptr_T;	/* block/index pair */
 
+/*
+ * A recently used data block and the stack leading to it, see
+ * ml_find_line().  Only valid until lines are inserted or deleted.
+ */
+#define ML_CACHE_SIZE	8	/* number of data blocks remembered */
+#define ML_CACHE_DEPTH	6	/* max. number of pointer blocks above it */
+
+typedef struct
+{
+    blocknr_T	mc_bnum;	/* data block number */
+    int		mc_page_count;	/* number of pages in the data block */
+    linenr_T	mc_low;		/* first line in the data block */
+    linenr_T	mc_high;	/* last line in the data block */
+    long	mc_used;	/* value of ml_cache_tick when last used */
+    int		mc_depth;	/* number of entries in mc_stack */
+    infoptr_T	mc_stack[ML_CACHE_DEPTH];   /* ml_stack for the block */
+} mlcache_T;
+
 #ifdef FEAT_BYTEOFF
 typedef struct ml_chunksize
 {
@@ -678,6 +732,10 @@ typedef struct memline
     linenr_T	ml_locked_low;	/* first line in ml_locked */
     linenr_T	ml_locked_high;	/* last line in ml_locked */
     int		ml_locked_lineadd;  /* number of lines inserted in ml_locked */
+
+    mlcache_T	ml_cache[ML_CACHE_SIZE];    /* recently used data blocks */
+    int		ml_cache_len;	/* number of valid entries in ml_cache */
+    long	ml_cache_tick;	/* incremented for every cache hit or add */
 #ifdef FEAT_BYTEOFF
     chunksize_T *ml_chunksize;
     int		ml_numchunks;
@@ -151,6 +151,7 @@ NEW_TESTS = test_arabic.res \
 	    test_job_fails.res \
 	    test_json.res \
 	    test_langmap.res \
+	    test_lazyread.res \
 	    test_let.res \
 	    test_lineending.res \
 	    test_listlbr.res \
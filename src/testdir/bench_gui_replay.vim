@@ -0,0 +1,31 @@
+"Test for benchmarking the Qt GUI paint pipeline
+
+" Recording run, scroll through a file and quit
+if exists("g:bench_gui_scroll")
+	set nowrap
+	for i in range(500)
+		exe "normal! \<C-E>"
+		redraw
+	endfor
+	for i in range(100)
+		exe "normal! 5zl"
+		redraw
+	endfor
+	qa!
+endif
+
+so small.vim
+if !has("gui_qt") | finish | endif
+func! Replay(file)
+	let env='QT_QPA_PLATFORM=offscreen '
+	let trace='gui_replay.trace'
+	call system(env. 'QVIM_DRAW_TRACE='. trace.
+		\ " ../vim -g -f -u NONE -N --cmd 'let g:bench_gui_scroll=1'".
+		\ ' -S bench_gui_replay.vim '. a:file)
+	for run in range(3)
+	    let report=system(env. 'QVIM_DRAW_REPLAY='. trace. ' ../vim -g -f -u NONE -N')
+	    $put =printf('file: %s, run: %d', a:file, run)
+	    $put =split(report, '\n')
+	endfor
+	call delete(trace)
+endfunc
@@ -0,0 +1,52 @@
+"Test for benchmarking getting lines from the memline
+
+so small.vim
+if !has("reltime") | finish | endif
+
+" Minimal standard random number generator, avoids overflow with 32 bit
+" numbers.
+func! s:Random(seed)
+	let r = 16807 * (a:seed % 127773) - 2836 * (a:seed / 127773)
+	return r > 0 ? r : r + 2147483647
+endfunc
+
+func! s:Time(what, lines, count, start)
+	return printf('%s: %d lines, %d gets, time: %s',
+		\ a:what, a:lines, a:count, reltimestr(reltime(a:start)))
+endfunc
+
+" Get "count" lines from a buffer with "lines" lines in three ways:
+" sequential, random and alternating between two far apart places, like two
+" windows on the same buffer.
+func! Measure(lines, count)
+	let results = []
+	new
+	setlocal noswapfile
+	call setline(1, map(range(1, a:lines),
+		\ 'printf("%6d some text to fill up the line a bit", v:val)'))
+
+	let sstart = reltime()
+	for i in range(a:count)
+	    call getline(i % a:lines + 1)
+	endfor
+	call add(results, s:Time('sequential', a:lines, a:count, sstart))
+
+	let r = 1
+	let sstart = reltime()
+	for i in range(a:count)
+	    let r = s:Random(r)
+	    call getline(r % a:lines + 1)
+	endfor
+	call add(results, s:Time('random', a:lines, a:count, sstart))
+
+	let half = a:lines / 2
+	let sstart = reltime()
+	for i in range(a:count / 2)
+	    call getline(i % half + 1)
+	    call getline(i % half + half + 1)
+	endfor
+	call add(results, s:Time('two windows', a:lines, a:count, sstart))
+
+	bwipe!
+	$put =results
+endfunc
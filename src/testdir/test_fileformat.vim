@@ -31,3 +31,128 @@ func Test_fileformat_autocommand()
   au! BufReadPre Xfile
   bw!
 endfunc
+
+" Random number generator, Park and Miller.
+func s:Random(seed)
+  let r = 16807 * (a:seed % 127773) - 2836 * (a:seed / 127773)
+  return r > 0 ? r : r + 2147483647
+endfunc
+
+" Make a list of pieces for a file of about 300000 bytes: text and the
+" special bytes "NUL", "NL", "CR" and "CRLF", some from "special".  Text is
+" ASCII and multi-byte characters.  At the end of each block of 64 Kbyte,
+" where readfile() reads the next part, a piece is placed to cross it.
+func s:MakePieces(special)
+  let chars = ['é', '€', '𝄞']
+  let crossing = [[65536, chars[-1], 2], [131072, 'CRLF', 1],
+	\ [196608, chars[0], 1], [262144, a:special[-1], 0]]
+  let pieces = []
+  let offset = 0
+  let seed = 1
+  while offset < 300000
+    let seed = s:Random(seed)
+    if !empty(crossing) && offset + 50 > crossing[0][0]
+      " pad up to where the piece must start
+      let p = repeat('a', crossing[0][0] - crossing[0][2] - offset)
+      call add(pieces, p)
+      let offset += len(p)
+      let p = crossing[0][1]
+      call remove(crossing, 0)
+    elseif seed % 4 == 0
+      let p = a:special[seed / 4 % len(a:special)]
+    elseif seed % 4 == 1
+      let p = chars[seed / 4 % len(chars)]
+    else
+      let p = repeat(nr2char(char2nr('a') + seed / 4 % 26), seed / 100 % 41)
+    endif
+    call add(pieces, p)
+    let offset += p == 'CRLF' ? 2 : p =~ '^\u\+$' ? 1 : len(p)
+  endwhile
+  call add(pieces, a:special[-1])
+  return pieces
+endfunc
+
+" Write "pieces" to "fname".
+func s:WritePieces(pieces, fname)
+  let lines = []
+  let cur = ''
+  for p in a:pieces
+    if p == 'NL'
+      call add(lines, cur)
+      let cur = ''
+    elseif p == 'CRLF'
+      call add(lines, cur . "\r")
+      let cur = ''
+    else
+      let cur .= p == 'NUL' ? "\n" : p == 'CR' ? "\r" : p
+    endif
+  endfor
+  call add(lines, cur)
+  call writefile(lines, a:fname, 'b')
+endfunc
+
+" Return the lines expected when reading "pieces" with fileformat "ff", byte
+" by byte.
+func s:ExpectedLines(pieces, ff)
+  let lines = []
+  let cur = ''
+  for p in a:pieces
+    if p == 'NUL'
+      let cur .= "\n"
+    elseif p == 'NL'
+      if a:ff == 'mac'
+	let cur .= "\r"
+      else
+	call add(lines, cur)
+	let cur = ''
+      endif
+    elseif p == 'CR'
+      if a:ff == 'mac'
+	call add(lines, cur)
+	let cur = ''
+      else
+	let cur .= "\r"
+      endif
+    elseif p == 'CRLF'
+      call add(lines, a:ff == 'unix' ? cur . "\r" : cur)
+      let cur = a:ff == 'mac' ? "\r" : ''
+    else
+      let cur .= p
+    endif
+  endfor
+  if cur != ''
+    call add(lines, cur)
+  endif
+  return lines
+endfunc
+
+func Test_fileformat_read_line_breaks()
+  if !has('multi_byte') || &encoding != 'utf-8'
+    return
+  endif
+  " Lines are found several bytes at a time, check the result is the same as
+  " going over the bytes one by one.
+  set fileformats=unix,dos fileencodings=utf-8,latin1
+  for [ff, special] in [['unix', ['NUL', 'CR', 'CRLF', 'NL']],
+	\ ['dos', ['NUL', 'CR', 'CRLF']],
+	\ ['mac', ['NUL', 'NL', 'CRLF', 'CR']]]
+    let pieces = s:MakePieces(special)
+    call s:WritePieces(pieces, 'Xfile')
+    exe 'new ' . (ff == 'mac' ? '++ff=mac ' : '') . 'Xfile'
+    call assert_equal(ff, &fileformat)
+    call assert_equal('utf-8', &fileencoding)
+    call assert_equal(s:ExpectedLines(pieces, ff), getline(1, '$'))
+    bwipe!
+
+    " An illegal byte near the end makes it latin1.
+    call insert(pieces, "\xff", -1)
+    call s:WritePieces(pieces, 'Xfile')
+    exe 'new ' . (ff == 'mac' ? '++ff=mac ' : '') . 'Xfile'
+    call assert_equal('latin1', &fileencoding)
+    call assert_equal(map(s:ExpectedLines(pieces, ff),
+	  \ 'iconv(v:val, "latin1", "utf-8")'), getline(1, '$'))
+    bwipe!
+  endfor
+  call delete('Xfile')
+  set fileformats& fileencodings&
+endfunc
@@ -815,3 +815,14 @@ func Test_shellescape()
 
   let &shell = save_shell
 endfunc
+
+func Test_guiprofile()
+  if !has('gui_running')
+    " Without the Qt GUI there are no counters and no file is written.
+    call assert_equal({}, guiprofile())
+    call assert_equal({}, guiprofile('Xguiprofile'))
+    call assert_false(filereadable('Xguiprofile'))
+  endif
+  call assert_fails('call guiprofile([])', 'E730:')
+  call assert_fails('call guiprofile({})', 'E731:')
+endfunc
@@ -0,0 +1,173 @@
+" Test 'lazyread': large files used from a mapping of the file
+
+if !has('lazyread')
+  finish
+endif
+
+func s:MakeLines()
+  let lines = []
+  for i in range(1, 3000)
+    call add(lines, 'line ' . i . repeat('x', i % 50))
+  endfor
+  return lines
+endfunc
+
+func Test_lazyread_edit_write()
+  let lines = s:MakeLines()
+  call writefile(lines, 'Xlazy')
+  set lazyread=1
+  new Xlazy
+  call assert_equal(3000, line('$'))
+  call assert_equal(lines, getline(1, '$'))
+  call assert_equal(len(join(lines[:1999], "\n")) + 2, line2byte(2001))
+  call assert_equal(2001, byte2line(line2byte(2001)))
+
+  1000,1010d
+  call remove(lines, 999, 1009)
+  2000s/^/X/
+  let lines[1999] = 'X' . lines[1999]
+  $put ='last'
+  call add(lines, 'last')
+  call assert_equal(lines, getline(1, '$'))
+  w
+  call assert_equal(lines, readfile('Xlazy'))
+
+  " Writing in place does not change the text in the buffer
+  set nowritebackup nobackup
+  e!
+  call assert_equal(lines, getline(1, '$'))
+  1d
+  w
+  call assert_equal(lines[1:], readfile('Xlazy'))
+  call assert_equal(lines[1:], getline(1, '$'))
+
+  bwipe!
+  set lazyread& writebackup& backup&
+  call delete('Xlazy')
+endfunc
+
+func Test_lazyread_dos()
+  let lines = s:MakeLines()
+  call writefile(map(copy(lines), 'v:val . "\r"'), 'Xlazy')
+  set lazyread=1
+  new Xlazy
+  call assert_equal('dos', &fileformat)
+  call assert_equal(lines, getline(1, '$'))
+  w! Xlazy2
+  call assert_equal(readfile('Xlazy', 'b'), readfile('Xlazy2', 'b'))
+
+  bwipe!
+  set lazyread&
+  call delete('Xlazy')
+  call delete('Xlazy2')
+endfunc
+
+func Test_lazyread_small_file()
+  " Files smaller than 'lazyread' Kbyte are read normally
+  call writefile(['one', 'two'], 'Xlazy')
+  set lazyread=1
+  new Xlazy
+  call assert_equal(['one', 'two'], getline(1, '$'))
+  bwipe!
+  set lazyread&
+  call delete('Xlazy')
+endfunc
+
+func Test_lazyread_recover()
+  let lines = s:MakeLines()
+  call writefile(lines, 'Xlazy')
+  set lazyread=1
+  new Xlazy
+  500,510d
+  call remove(lines, 499, 509)
+  2500s/$/!/
+  let lines[2499] .= '!'
+  preserve
+  redir => swapname
+  swapname
+  redir END
+  let swapname = substitute(swapname, '\n', '', 'g')
+  let swapcopy = readfile(swapname, 'b')
+  bwipe!
+  set lazyread&
+
+  call writefile(swapcopy, 'Xlazy.swp', 'b')
+  new
+  recover Xlazy.swp
+  call assert_equal(lines, getline(1, '$'))
+  bwipe!
+  call delete('Xlazy')
+  call delete('Xlazy.swp')
+endfunc
+
+func Test_lazyread_overwritten()
+  let lines = s:MakeLines()
+  call writefile(lines, 'Xlazy')
+  set lazyread=1
+  new Xlazy
+
+  " Writing the file by name first copies the text
+  call writefile(['short'], 'Xlazy')
+  call assert_equal(lines, getline(1, '$'))
+  redir! > Xlazy
+  echo 'redirected'
+  redir END
+  call assert_equal(lines, getline(1, '$'))
+
+  bwipe!
+  set lazyread&
+  call delete('Xlazy')
+endfunc
+
+func Test_lazyread_truncated()
+  if !executable('sh')
+    return
+  endif
+  let lines = s:MakeLines()
+  call writefile(lines, 'Xlazy')
+  set lazyread=1
+  new Xlazy
+  call assert_equal(lines[:9], getline(1, 10))
+
+  " Another program truncates the file: the lines that were not used yet
+  " are gone, that must not crash
+  call system('echo short > Xlazy')
+  call assert_fails('let l = getline(2900)', 'E949:')
+  call assert_equal('', getline(2900))
+  call assert_equal(lines[:9], getline(1, 10))
+  call assert_equal(3000, line('$'))
+
+  bwipe!
+  set lazyread&
+  call delete('Xlazy')
+endfunc
+
+func Test_lazyread_alloc_fail()
+  let lines = []
+  for i in range(1, 200000)
+    call add(lines, 'line ' . i . repeat('x', 40))
+  endfor
+  call writefile(lines, 'Xlazy')
+  set lazyread=1
+
+  " Failing halfway building the tree reads the file the usual way
+  call test_alloc_fail(GetAllocId('lazy_ptrs'), 1, 0)
+  let caught = 0
+  try
+    new Xlazy
+  catch /E342:/
+    let caught = 1
+  endtry
+  call assert_equal(1, caught)
+  call assert_equal(lines, getline(1, '$'))
+  100000,100010d
+  call remove(lines, 99999, 100009)
+  preserve
+  call assert_equal(lines, getline(1, '$'))
+  w
+  call assert_equal(lines, readfile('Xlazy'))
+
+  bwipe!
+  set lazyread&
+  call delete('Xlazy')
+endfunc
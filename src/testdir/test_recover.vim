@@ -1,5 +1,9 @@
 " Test :recover
 
+if !exists('*RunVim')
+  source shared.vim
+endif
+
 func Test_recover_root_dir()
   " This used to access invalid memory.
   split Xtest
@@ -16,3 +20,95 @@ func Test_recover_root_dir()
 endfunc
 
 " TODO: move recover tests from test78.in to here.
+
+func Test_recover_swap_thread()
+  if !has('swapthread')
+    return
+  endif
+  " With 'updatecount' 1 every typed character queues writes for the writer
+  " thread, preserving must write after them.
+  new Xswapthread
+  set updatecount=1
+  call feedkeys("ione\<CR>two\<CR>three\<Esc>kddGothe end\<Esc>", 'tx')
+  preserve
+  redir => swapname
+  swapname
+  redir END
+  let swapname = substitute(swapname, '\n', '', 'g')
+  call writefile(readfile(swapname, 'b'), 'Xswapthread.swp', 'b')
+  set updatecount&
+  bwipe!
+
+  new
+  recover Xswapthread.swp
+  call assert_equal(['one', 'three', 'the end'], getline(1, '$'))
+  bwipe!
+  call delete('Xswapthread.swp')
+endfunc
+
+func Test_recover_swap_thread_signal()
+  if !has('swapthread') || !executable('kill') || !executable('sleep')
+    return
+  endif
+  " Preserving for a deadly signal while writes are queued must not hang.
+  let after = [
+	\ 'set updatecount=1',
+	\ 'call feedkeys("ione\<CR>two\<CR>three\<Esc>kdd", "tx")',
+	\ 'call system("(sleep 1; kill -TERM " . getpid() . ") >/dev/null 2>&1 &")',
+	\ 'sleep 5',
+	\ 'qall!',
+	\ ]
+  if !RunVim([], after, 'Xsigterm')
+    return
+  endif
+  call assert_true(filereadable('.Xsigterm.swp'))
+
+  new
+  recover .Xsigterm.swp
+  call assert_equal(['one', 'three'], getline(1, '$'))
+  bwipe!
+  call delete('.Xsigterm.swp')
+endfunc
+
+func Test_recover_distant_lines()
+  " Getting lines far apart in turn uses remembered data blocks, they must
+  " be forgotten when lines are added or deleted and when preserving.
+  new Xdistant
+  let lines = []
+  for i in range(1, 30000)
+    call add(lines, 'line ' . i . repeat('x', i % 50))
+  endfor
+  call setline(1, lines)
+  let targets = [1, 4000, 9000, 15000, 21000, 29000]
+  for round in range(300)
+    for t in targets + reverse(copy(targets))
+      call assert_equal(lines[t - 1], getline(t))
+    endfor
+    let lnum = targets[round % len(targets)] + round % 7
+    if round % 3 == 0
+      exe lnum . 'delete'
+      call remove(lines, lnum - 1)
+    else
+      call append(lnum, 'added ' . round)
+      call insert(lines, 'added ' . round, lnum)
+    endif
+    if round % 50 == 0
+      preserve
+    endif
+  endfor
+  call assert_equal(lines, getline(1, '$'))
+
+  preserve
+  redir => swapname
+  swapname
+  redir END
+  let swapname = substitute(swapname, '\n', '', 'g')
+  call writefile(readfile(swapname, 'b'), 'Xdistant.swp', 'b')
+  bwipe!
+
+  new
+  recover Xdistant.swp
+  call assert_equal(lines, getline(1, '$'))
+  bwipe!
+  call delete('Xdistant.swp')
+endfunc
@@ -49,3 +49,57 @@ func Test_writefile_fails_conversion()
   bwipe!
   set backup& writebackup&
 endfunc
+
+func Test_write_special_characters()
+  new
+  let long = repeat('0123456789', 10000)
+  call setline(1, ["one\ntwo", long, "cr\rhere", ''])
+  for [ff, result] in [
+	\ ['unix', ["one\ntwo", long, "cr\rhere", '', '']],
+	\ ['dos', ["one\ntwo\r", long . "\r", "cr\rhere\r", "\r", '']],
+	\ ['mac', ["one\ntwo\r" . long . "\rcr", "here\r\r"]]]
+    let &l:fileformat = ff
+    write! Xfile
+    call assert_equal(result, readfile('Xfile', 'b'), ff)
+  endfor
+  call delete('Xfile')
+  bwipe!
+endfunc
+
+func Test_write_backupcopy()
+  let lines = ['first', repeat('x', 100000), 'last']
+  call writefile(lines, 'Xfile')
+  set backup backupcopy=yes backupdir=. backupskip=
+  new Xfile
+  call setline(1, 'changed')
+  write
+  call assert_equal(lines, readfile('Xfile~'))
+  call assert_equal(['changed'] + lines[1:], readfile('Xfile'))
+  call delete('Xfile')
+  call delete('Xfile~')
+  bwipe!
+  set backup& backupcopy& backupdir& backupskip&
+endfunc
+
+func Test_write_backupcopy_chunks()
+  " Without cloning the file the backup is copied by the kernel when
+  " possible, in small pieces here.  The size is not a multiple of the
+  " piece size.
+  let lines = []
+  for i in range(1, 20000)
+    call add(lines, i . repeat('x', i % 37))
+  endfor
+  call writefile(lines, 'Xfile')
+  call test_override('copy_chunk', 1000)
+  set backup backupcopy=yes backupdir=. backupskip=
+  new Xfile
+  call setline(1, 'changed')
+  write
+  call assert_equal(lines, readfile('Xfile~'))
+  call assert_equal(['changed'] + lines[1:], readfile('Xfile'))
+  call delete('Xfile')
+  call delete('Xfile~')
+  bwipe!
+  set backup& backupcopy& backupdir& backupskip&
+  call test_override('copy_chunk', 0)
+endfunc
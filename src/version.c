@@ -315,6 +315,11 @@ static char *(features[]) =
 #else
 	"-langmap",
 #endif
+#ifdef FEAT_LAZYREAD
+	"+lazyread",
+#else
+	"-lazyread",
+#endif
 #ifdef FEAT_LIBCALL
 	"+libcall",
 #else
@@ -580,6 +585,11 @@ static char *(features[]) =
 #else
 	"-sun_workshop",
 #endif
+#ifdef FEAT_SWAP_THREAD
+	"+swapthread",
+#else
+	"-swapthread",
+#endif
 #ifdef FEAT_SYN_HL
 	"+syntax",
 #else
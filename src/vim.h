@@ -1095,6 +1095,7 @@ extern int (*dyn_libintl_putenv)(const char *envstring);
 #define MFS_STOP	2	/* stop syncing when a character is available */
 #define MFS_FLUSH	4	/* flushed file to disk */
 #define MFS_ZERO	8	/* only write block 0 */
+#define MFS_ASYNC	16	/* write in the writer thread if possible */
 
 /* flags for buf_copy_options() */
 #define BCO_ENTER	1	/* going to enter the buffer */
@@ -2155,8 +2156,9 @@ typedef enum {
 # define number_width(x) 7
 #endif
 
-/* This must come after including proto.h */
-#if !(defined(FEAT_MBYTE) && defined(WIN3264))
+/* This must come after including proto.h.
+ * With +lazyread these are functions in os_unix.c. */
+#if !(defined(FEAT_MBYTE) && defined(WIN3264)) && !defined(FEAT_LAZYREAD)
 # define mch_open(n, m, p)	open((n), (m), (p))
 # define mch_fopen(n, p)	fopen((n), (p))
 #endif